@@ -0,0 +1,240 @@
+// Micro-benchmarks for the hot paths of a single event: JSON (de)serialization,
+// Ed25519 signatures, request parsing, connection pool lookups and field
+// arithmetic.
+//
+// Emit JSON with: tribune_microbench --benchmark_format=json
+// (or --benchmark_out=FILE --benchmark_out_format=json)
+
+#include "crypto/signature.hpp"
+#include "events/events.hpp"
+#include "mpc/field_ops.hpp"
+#include "mpc/shamir.hpp"
+#include "protocol/parser.hpp"
+#include "utils/connection_pool.hpp"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Hex strings of the same length as real keys and signatures
+const std::string FAKE_PUBLIC_KEY(64, 'a');
+const std::string FAKE_SIGNATURE(128, 'b');
+
+Event makeEvent(int participants) {
+  Event event;
+  event.type_ = DataRequestEvent;
+  event.event_id = "3f2a9c1e-8d4b-4e6f-9a7c-1b2d3e4f5a6b";
+  event.computation_type = "secure_sum";
+  event.computation_metadata = {{"vector_length", 16}};
+  event.server_signature = FAKE_SIGNATURE;
+  for (int i = 0; i < participants; i++) {
+    ClientInfo info;
+    info.client_id = "client-" + std::to_string(i);
+    info.client_host = "localhost";
+    info.client_port = std::to_string(9000 + i);
+    info.ed25519_pub = FAKE_PUBLIC_KEY;
+    event.participants.push_back(info);
+  }
+  return event;
+}
+
+PeerDataMessage makePeerDataMessage(int participants) {
+  PeerDataMessage msg;
+  msg.event_id = "3f2a9c1e-8d4b-4e6f-9a7c-1b2d3e4f5a6b";
+  msg.from_client = "client-0";
+  msg.data = "1234567890123456789";
+  msg.signature = FAKE_SIGNATURE;
+  msg.timestamp = std::chrono::system_clock::now();
+  msg.original_event = makeEvent(participants);
+  return msg;
+}
+
+// ===== Serialization =====
+
+void BM_EventToJson(benchmark::State &state) {
+  Event event = makeEvent(static_cast<int>(state.range(0)));
+  for ([[maybe_unused]] auto _ : state) {
+    nlohmann::json j = event;
+    std::string body = j.dump();
+    benchmark::DoNotOptimize(body);
+  }
+}
+BENCHMARK(BM_EventToJson)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_EventFromJson(benchmark::State &state) {
+  std::string body = nlohmann::json(makeEvent(static_cast<int>(state.range(0)))).dump();
+  for ([[maybe_unused]] auto _ : state) {
+    Event event = nlohmann::json::parse(body).get<Event>();
+    benchmark::DoNotOptimize(event);
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_EventFromJson)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_PeerDataMessageToJson(benchmark::State &state) {
+  PeerDataMessage msg = makePeerDataMessage(static_cast<int>(state.range(0)));
+  for ([[maybe_unused]] auto _ : state) {
+    nlohmann::json j = msg;
+    std::string body = j.dump();
+    benchmark::DoNotOptimize(body);
+  }
+}
+BENCHMARK(BM_PeerDataMessageToJson)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_PeerDataMessageFromJson(benchmark::State &state) {
+  std::string body =
+      nlohmann::json(makePeerDataMessage(static_cast<int>(state.range(0)))).dump();
+  for ([[maybe_unused]] auto _ : state) {
+    PeerDataMessage msg = nlohmann::json::parse(body).get<PeerDataMessage>();
+    benchmark::DoNotOptimize(msg);
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_PeerDataMessageFromJson)->RangeMultiplier(4)->Range(4, 1024);
+
+// ===== Signatures =====
+
+void BM_CreateSignature(benchmark::State &state) {
+  auto keypair = SignatureUtils::generateKeyPair();
+  std::string message(state.range(0), 'x');
+  for ([[maybe_unused]] auto _ : state) {
+    std::string signature = SignatureUtils::createSignature(message, keypair.second);
+    benchmark::DoNotOptimize(signature);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+BENCHMARK(BM_CreateSignature)->Arg(64)->Arg(1024)->Arg(16384);
+
+void BM_VerifySignature(benchmark::State &state) {
+  auto keypair = SignatureUtils::generateKeyPair();
+  std::string message(state.range(0), 'x');
+  std::string signature = SignatureUtils::createSignature(message, keypair.second);
+  for ([[maybe_unused]] auto _ : state) {
+    bool valid = SignatureUtils::verifySignature(message, signature, keypair.first);
+    benchmark::DoNotOptimize(valid);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+BENCHMARK(BM_VerifySignature)->Arg(64)->Arg(1024)->Arg(16384);
+
+// ===== Request parsing =====
+
+void BM_ParseSubmitResponse(benchmark::State &state) {
+  EventResponse response;
+  response.type_ = DataPart;
+  response.event_id = "3f2a9c1e-8d4b-4e6f-9a7c-1b2d3e4f5a6b";
+  response.client_id = "client-0";
+  response.data = nlohmann::json(std::vector<uint64_t>(state.range(0), 42)).dump();
+  response.timestamp = std::chrono::system_clock::now();
+  std::string body = nlohmann::json(response).dump();
+
+  for ([[maybe_unused]] auto _ : state) {
+    auto parsed = parseSubmitResponse(body);
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetBytesProcessed(state.iterations() * body.size());
+}
+BENCHMARK(BM_ParseSubmitResponse)->Arg(1)->Arg(64)->Arg(4096);
+
+void BM_ParseConnectResponse(benchmark::State &state) {
+  ConnectResponse request;
+  request.type_ = ConnectionRequest;
+  request.client_host = "localhost";
+  request.client_port = "9000";
+  request.client_id = "client-0";
+  request.ed25519_pub = FAKE_PUBLIC_KEY;
+  std::string body = nlohmann::json(request).dump();
+
+  for ([[maybe_unused]] auto _ : state) {
+    auto parsed = parseConnectResponse(body);
+    benchmark::DoNotOptimize(parsed);
+  }
+}
+BENCHMARK(BM_ParseConnectResponse);
+
+// ===== Connection pool =====
+
+// Lookups of already pooled peers from several threads at once. No request is
+// sent, so this measures only key construction and the pool's locking.
+void BM_ConnectionPoolWithConnection(benchmark::State &state) {
+  static ConnectionPool pool;
+  static constexpr int PEERS = 64;
+  if (state.thread_index() == 0) {
+    for (int i = 0; i < PEERS; i++) {
+      pool.withConnection("localhost", 9000 + i, [](auto *) { return true; });
+    }
+  }
+
+  int peer = state.thread_index();
+  for ([[maybe_unused]] auto _ : state) {
+    bool found = pool.withConnection("localhost", 9000 + peer % PEERS,
+                                     [](auto *client) { return client != nullptr; });
+    benchmark::DoNotOptimize(found);
+    peer++;
+  }
+}
+BENCHMARK(BM_ConnectionPoolWithConnection)->ThreadRange(1, 16)->UseRealTime();
+
+// ===== Field arithmetic =====
+
+// Element throughput of one FieldOps kernel on one core. Arguments are the
+// array length and the SimdLevel; levels the CPU lacks are skipped.
+template <typename T, FieldOps::Op op>
+void BM_FieldOp(benchmark::State &state) {
+  auto level = static_cast<SimdLevel>(state.range(1));
+  if (level > FieldOps::detectedSimd()) {
+    state.SkipWithError("Kernel not supported on this CPU");
+    return;
+  }
+  std::vector<T> acc(state.range(0)), b(state.range(0));
+  for (size_t i = 0; i < acc.size(); i++) {
+    acc[i] = FieldTraits<T>::random();
+    b[i] = FieldTraits<T>::random();
+  }
+  T c = FieldTraits<T>::random();
+  for ([[maybe_unused]] auto _ : state) {
+    FieldOps::apply<op, T>(std::span<T>(acc), std::span<const T>(b), c, level);
+    benchmark::DoNotOptimize(acc.data());
+  }
+  state.SetItemsProcessed(state.iterations() * acc.size());
+  state.SetLabel(toString(level));
+}
+
+void fieldArgs(benchmark::internal::Benchmark *b) {
+  for (int level : {0, 1, 2}) {
+    b->Args({1024, level})->Args({65536, level});
+  }
+}
+
+using FieldOp = FieldOps::Op;
+BENCHMARK_TEMPLATE(BM_FieldOp, uint64_t, FieldOp::Add)->Apply(fieldArgs);
+BENCHMARK_TEMPLATE(BM_FieldOp, uint64_t, FieldOp::Mul)->Apply(fieldArgs);
+BENCHMARK_TEMPLATE(BM_FieldOp, uint64_t, FieldOp::Axpy)->Apply(fieldArgs);
+BENCHMARK_TEMPLATE(BM_FieldOp, Fp61, FieldOp::Add)->Apply(fieldArgs);
+BENCHMARK_TEMPLATE(BM_FieldOp, Fp61, FieldOp::Mul)->Apply(fieldArgs);
+BENCHMARK_TEMPLATE(BM_FieldOp, Fp61, FieldOp::Axpy)->Apply(fieldArgs);
+// Scalar only
+BENCHMARK_TEMPLATE(BM_FieldOp, Fp127, FieldOp::Add)->Args({1024, 0})->Args({65536, 0});
+BENCHMARK_TEMPLATE(BM_FieldOp, Fp127, FieldOp::Mul)->Args({1024, 0})->Args({65536, 0});
+BENCHMARK_TEMPLATE(BM_FieldOp, Fp127, FieldOp::Axpy)->Args({1024, 0})->Args({65536, 0});
+
+// Shamir share generation for one client's vector, including the JSON wire
+// encoding: 8 participants, threshold 4
+void BM_ShamirShareInto(benchmark::State &state) {
+  Event event = makeEvent(8);
+  ShamirSumModule module(4);
+  std::string raw = nlohmann::json(std::vector<uint64_t>(state.range(0), 42)).dump();
+  std::vector<std::string> out;
+  for ([[maybe_unused]] auto _ : state) {
+    module.shardDataInto(std::as_bytes(std::span(raw)), &event, "client-0", out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ShamirShareInto)->Arg(1024)->Arg(65536);
+
+} // namespace
+
+BENCHMARK_MAIN();
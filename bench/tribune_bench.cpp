@@ -0,0 +1,511 @@
+// End-to-end benchmark: one TribuneServer and N TribuneClients on loopback in
+// a single process. Runs a configurable event workload and prints the results
+// as JSON so runs can be diffed and gated in CI.
+//
+// Usage: tribune_bench [--clients N] [--participants P] [--events E]
+//                      [--concurrency C] [--payload L] [--server-port PORT]
+//                      [--client-base-port PORT] [--timeout SECONDS]
+//                      [--output FILE]
+//
+// Library logging is muted while the harness runs, so stdout carries only the
+// JSON report.
+
+#include "client/tribune_client.hpp"
+#include "mpc/mpc_module.hpp"
+#include "server/tribune_server.hpp"
+#include <sys/resource.h>
+#ifdef __APPLE__
+#include <ifaddrs.h>
+#include <net/if.h>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct BenchOptions {
+  int clients = 8;
+  int participants = 4;
+  int events = 50;
+  int concurrency = 1;
+  int payload = 16; // Vector elements contributed by each participant
+  int server_port = 18080;
+  int client_base_port = 18100;
+  int timeout_seconds = 30;
+  std::string output;
+};
+
+bool parseOptions(int argc, char *argv[], BenchOptions &opts) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (i + 1 >= argc) {
+      std::cerr << "Missing value for " << arg << std::endl;
+      return false;
+    }
+    std::string value = argv[++i];
+    try {
+      if (arg == "--clients") opts.clients = std::stoi(value);
+      else if (arg == "--participants") opts.participants = std::stoi(value);
+      else if (arg == "--events") opts.events = std::stoi(value);
+      else if (arg == "--concurrency") opts.concurrency = std::stoi(value);
+      else if (arg == "--payload") opts.payload = std::stoi(value);
+      else if (arg == "--server-port") opts.server_port = std::stoi(value);
+      else if (arg == "--client-base-port") opts.client_base_port = std::stoi(value);
+      else if (arg == "--timeout") opts.timeout_seconds = std::stoi(value);
+      else if (arg == "--output") opts.output = value;
+      else {
+        std::cerr << "Unknown option: " << arg << std::endl;
+        return false;
+      }
+    } catch (const std::exception &) {
+      std::cerr << "Invalid value for " << arg << ": " << value << std::endl;
+      return false;
+    }
+  }
+
+  // Clients refuse to share with fewer than 4 participants
+  if (opts.participants < 4 || opts.clients < opts.participants) {
+    std::cerr << "Need --participants >= 4 and --clients >= --participants"
+              << std::endl;
+    return false;
+  }
+  if (opts.events < 1 || opts.concurrency < 1 || opts.payload < 1) {
+    std::cerr << "--events, --concurrency and --payload must be >= 1"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Additive secret sharing of a uint64 vector (wrapping arithmetic). Shards and
+// partials travel as JSON arrays, mirroring how real modules encode payloads.
+class BenchSumModule : public MPCModule {
+public:
+  BenchSumModule() : rng_(std::random_device{}()) {}
+
+  std::vector<DataShard> shardData(const std::string &raw_data,
+                                   const Event *event) override {
+    std::vector<uint64_t> values =
+        nlohmann::json::parse(raw_data).get<std::vector<uint64_t>>();
+    size_t count = event->participants.size();
+
+    std::vector<std::vector<uint64_t>> shards(count,
+                                              std::vector<uint64_t>(values.size()));
+    {
+      std::lock_guard<std::mutex> lock(rng_mutex_);
+      for (size_t j = 0; j < values.size(); j++) {
+        uint64_t remainder = values[j];
+        for (size_t i = 1; i < count; i++) {
+          shards[i][j] = rng_();
+          remainder -= shards[i][j];
+        }
+        shards[0][j] = remainder;
+      }
+    }
+
+    std::vector<DataShard> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+      result.push_back(DataShard{event->participants[i].client_id,
+                                 nlohmann::json(shards[i]).dump(),
+                                 static_cast<int>(i), nlohmann::json::object()});
+    }
+    return result;
+  }
+
+  std::vector<DataShard> maskShards(const std::vector<DataShard> &shards,
+                                    const Event *event,
+                                    const std::string &participant_id) override {
+    return shards; // Additive shares are already uniformly random
+  }
+
+  // Masking is the identity, so the shards move straight into out
+  void shardDataInto(std::span<const std::byte> raw_data, const Event *event,
+                     const std::string &participant_id,
+                     std::vector<std::string> &out) override {
+    std::vector<DataShard> shards =
+        shardData(std::string(reinterpret_cast<const char *>(raw_data.data()),
+                              raw_data.size()),
+                  event);
+    out.resize(shards.size());
+    for (size_t i = 0; i < shards.size(); i++) {
+      out[i] = std::move(shards[i].data);
+    }
+  }
+
+  PartialResult
+  computePartial(const Event *event,
+                 const std::vector<DataShard> &collected_shards) override {
+    std::vector<uint64_t> sum;
+    for (const auto &shard : collected_shards) {
+      addInto(sum, nlohmann::json::parse(shard.data).get<std::vector<uint64_t>>());
+    }
+    PartialResult partial;
+    partial.value = sum;
+    return partial;
+  }
+
+  PartialResult computePartialViews(const Event *event,
+                                    std::span<const ShardView> shards) override {
+    PartialResult partial;
+    partial.value = sumShards(shards);
+    return partial;
+  }
+
+  void computePartialInto(const Event *event, std::span<const ShardView> shards,
+                          std::string &out) override {
+    out = nlohmann::json(sumShards(shards)).dump();
+  }
+
+  FinalResult aggregate(const std::vector<PartialResult> &partials,
+                        const Event *event) override {
+    std::vector<uint64_t> sum;
+    for (const auto &partial : partials) {
+      addInto(sum, partial.value.get<std::vector<uint64_t>>());
+    }
+    FinalResult result;
+    result.value = sum;
+    result.verified = true;
+    return result;
+  }
+
+  // Sums are associative, so aggregation tree nodes can pre-add partials
+  std::optional<PartialResult>
+  combinePartials(const std::vector<PartialResult> &partials,
+                  const Event *event) override {
+    std::vector<uint64_t> sum;
+    for (const auto &partial : partials) {
+      addInto(sum, partial.value.get<std::vector<uint64_t>>());
+    }
+    PartialResult combined;
+    combined.value = sum;
+    return combined;
+  }
+
+  bool verifyResult(const FinalResult &result, const Event *event) override {
+    return result.verified;
+  }
+
+  bool isProtocolComplete(const std::string &event_id) const override {
+    return false;
+  }
+
+  void reset(const std::string &event_id) override {}
+
+  ProtocolMetadata getProtocolMetadata() const override {
+    return ProtocolMetadata{"bench_sum", 4, 0, false, nlohmann::json::object()};
+  }
+
+private:
+  static void addInto(std::vector<uint64_t> &acc,
+                      const std::vector<uint64_t> &values) {
+    if (acc.empty()) {
+      acc.resize(values.size(), 0);
+    }
+    for (size_t i = 0; i < acc.size() && i < values.size(); i++) {
+      acc[i] += values[i];
+    }
+  }
+
+  static std::vector<uint64_t> sumShards(std::span<const ShardView> shards) {
+    std::vector<uint64_t> sum;
+    for (const auto &shard : shards) {
+      addInto(sum, nlohmann::json::parse(shard.data).get<std::vector<uint64_t>>());
+    }
+    return sum;
+  }
+
+  std::mt19937_64 rng_;
+  std::mutex rng_mutex_;
+};
+
+// Every client contributes a vector filled with (client index + 1), so the
+// expected sum of any event is known from its participant list alone.
+class BenchDataModule : public DataCollectionModule {
+public:
+  explicit BenchDataModule(uint64_t value) : value_(value) {}
+
+  std::string collectData(const Event &event) override {
+    size_t length = event.computation_metadata.value("vector_length", 1);
+    return nlohmann::json(std::vector<uint64_t>(length, value_)).dump();
+  }
+
+private:
+  uint64_t value_;
+};
+
+// Bytes sent over the loopback interface, or -1 where unsupported. This also
+// counts unrelated loopback traffic on the host, so run on a quiet machine.
+int64_t readLoopbackBytes() {
+#ifdef __APPLE__
+  struct ifaddrs *addrs = nullptr;
+  if (getifaddrs(&addrs) != 0) {
+    return -1;
+  }
+  int64_t bytes = -1;
+  for (struct ifaddrs *ifa = addrs; ifa != nullptr; ifa = ifa->ifa_next) {
+    if (ifa->ifa_addr != nullptr && ifa->ifa_addr->sa_family == AF_LINK &&
+        ifa->ifa_data != nullptr && std::string(ifa->ifa_name) == "lo0") {
+      bytes = static_cast<const struct if_data *>(ifa->ifa_data)->ifi_obytes;
+    }
+  }
+  freeifaddrs(addrs);
+  return bytes;
+#else
+  std::ifstream dev("/proc/net/dev");
+  std::string line;
+  while (std::getline(dev, line)) {
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+    std::string name = line.substr(0, colon);
+    name.erase(0, name.find_first_not_of(' '));
+    if (name != "lo") {
+      continue;
+    }
+    std::istringstream fields(line.substr(colon + 1));
+    int64_t value = 0;
+    // Receive columns come first: bytes packets errs drop fifo frame
+    // compressed multicast, then transmit bytes
+    for (int i = 0; i < 9; i++) {
+      fields >> value;
+    }
+    return fields ? value : -1;
+  }
+  return -1;
+#endif
+}
+
+double cpuSeconds() {
+  struct rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Polls an endpoint until it answers, so the workload starts on live sockets
+bool waitForEndpoint(const std::string &host, int port, const std::string &path,
+                     bool post) {
+  httplib::Client cli(host, port);
+  cli.set_connection_timeout(0, 200000);
+  for (int attempt = 0; attempt < 50; attempt++) {
+    auto res = post ? cli.Post(path, "{}", "application/json") : cli.Get(path);
+    if (res && res->status == 200) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  BenchOptions opts;
+  if (!parseOptions(argc, argv, opts)) {
+    return 1;
+  }
+
+  const std::string host = "localhost";
+  std::streambuf *stdout_buf = std::cout.rdbuf(nullptr);
+
+  // Start from library defaults rather than whatever server.json is on disk
+  ServerConfig server_config("");
+  server_config.min_participants = opts.participants;
+  server_config.max_participants = opts.participants;
+  server_config.event_timeout_boundary = opts.timeout_seconds;
+  server_config.ping_interval_seconds = 1;
+  server_config.client_timeout_seconds = 3600;
+
+  TribuneServer server(host, opts.server_port, server_config);
+  server.registerModule("bench_sum", std::make_unique<BenchSumModule>());
+  std::thread server_thread([&server]() { server.start(); });
+
+  std::vector<std::unique_ptr<TribuneClient>> clients;
+  auto shutdown = [&]() {
+    for (auto &client : clients) {
+      client->stop();
+    }
+    server.stop();
+    server_thread.join();
+    std::cout.rdbuf(stdout_buf);
+    std::cout.clear();
+  };
+
+  if (!waitForEndpoint(host, opts.server_port, "/", false)) {
+    std::cerr << "Server did not come up on port " << opts.server_port << std::endl;
+    shutdown();
+    return 1;
+  }
+
+  ClientConfig client_config("");
+  std::unordered_map<std::string, uint64_t> client_values;
+  for (int i = 0; i < opts.clients; i++) {
+    auto keypair = SignatureUtils::generateKeyPair();
+    int port = opts.client_base_port + i;
+    auto client = std::make_unique<TribuneClient>(
+        host, opts.server_port, host, port, keypair.second, keypair.first,
+        client_config);
+    client->registerModule("bench_sum", std::make_unique<BenchSumModule>());
+    client->setDataCollectionModule(std::make_unique<BenchDataModule>(i + 1));
+    client_values[client->getClientId()] = i + 1;
+
+    client->startListening();
+    bool ready = waitForEndpoint(host, port, "/ping", true) &&
+                 client->connectToSeed();
+    clients.push_back(std::move(client));
+    if (!ready) {
+      std::cerr << "Client " << i << " failed to start on port " << port
+                << std::endl;
+      shutdown();
+      return 1;
+    }
+  }
+
+  // ===== Workload =====
+
+  std::atomic<int> next_event{0};
+  std::atomic<int> failed{0};
+  std::atomic<int> verified{0};
+  std::vector<double> latencies_ms;
+  std::mutex latencies_mutex;
+
+  int64_t bytes_before = readLoopbackBytes();
+  double cpu_before = cpuSeconds();
+  auto wall_start = std::chrono::steady_clock::now();
+
+  std::vector<std::thread> workers;
+  for (int w = 0; w < opts.concurrency; w++) {
+    workers.emplace_back([&]() {
+      for (int n = next_event++; n < opts.events; n = next_event++) {
+        std::string event_id = "bench-" + std::to_string(n);
+        auto event = server.createEvent(DataRequestEvent, event_id, "bench_sum");
+        if (!event) {
+          failed++;
+          continue;
+        }
+        event->computation_metadata["vector_length"] = opts.payload;
+
+        uint64_t expected = 0;
+        for (const auto &participant : event->participants) {
+          expected += client_values[participant.client_id];
+        }
+
+        // Stamp completion on the aggregating thread, not when this worker
+        // gets around to waking up
+        std::promise<std::pair<std::chrono::steady_clock::time_point, EventOutcome>>
+            completion;
+        auto completed = completion.get_future();
+        auto start = std::chrono::steady_clock::now();
+        server.announceEvent(*event, [&completion](const EventOutcome &outcome) {
+          completion.set_value({std::chrono::steady_clock::now(), outcome});
+        });
+
+        // The server settles every event by event_timeout_boundary
+        auto [done, outcome] = completed.get();
+        if (!outcome.ok()) {
+          failed++;
+          continue;
+        }
+
+        auto sum = outcome.result->value.get<std::vector<uint64_t>>();
+        if (sum.size() == static_cast<size_t>(opts.payload) &&
+            std::all_of(sum.begin(), sum.end(),
+                        [&](uint64_t v) { return v == expected; })) {
+          verified++;
+        }
+
+        std::lock_guard<std::mutex> lock(latencies_mutex);
+        latencies_ms.push_back(
+            std::chrono::duration<double, std::milli>(done - start).count());
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  double wall_seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - wall_start)
+                            .count();
+  double cpu_used = cpuSeconds() - cpu_before;
+  int64_t bytes_after = readLoopbackBytes();
+
+  // ===== Report =====
+
+  std::sort(latencies_ms.begin(), latencies_ms.end());
+  size_t completed = latencies_ms.size();
+  double mean = 0.0;
+  for (double l : latencies_ms) {
+    mean += l;
+  }
+  if (completed > 0) {
+    mean /= completed;
+  }
+
+  nlohmann::json bytes_on_wire = nullptr;
+  nlohmann::json bytes_per_event = nullptr;
+  if (bytes_before >= 0 && bytes_after >= 0) {
+    bytes_on_wire = bytes_after - bytes_before;
+    if (completed > 0) {
+      bytes_per_event = static_cast<double>(bytes_after - bytes_before) / completed;
+    }
+  }
+
+  nlohmann::json report = {
+      {"benchmark", "tribune_e2e"},
+      {"config",
+       {{"clients", opts.clients},
+        {"participants", opts.participants},
+        {"events", opts.events},
+        {"concurrency", opts.concurrency},
+        {"payload", opts.payload}}},
+      {"results",
+       {{"events_completed", completed},
+        {"events_failed", failed.load()},
+        {"events_verified", verified.load()},
+        {"wall_seconds", wall_seconds},
+        {"events_per_second", wall_seconds > 0 ? completed / wall_seconds : 0.0},
+        {"latency_ms",
+         {{"p50", percentile(latencies_ms, 0.50)},
+          {"p99", percentile(latencies_ms, 0.99)},
+          {"mean", mean},
+          {"max", completed > 0 ? latencies_ms.back() : 0.0}}},
+        {"bytes_on_wire", bytes_on_wire},
+        {"bytes_per_event", bytes_per_event},
+        {"cpu_us_per_event",
+         completed > 0 ? cpu_used * 1e6 / completed : 0.0}}}};
+
+  shutdown();
+
+  if (opts.output.empty()) {
+    std::cout << report.dump(2) << std::endl;
+  } else {
+    std::ofstream out(opts.output);
+    out << report.dump(2) << std::endl;
+  }
+
+  return failed.load() == 0 ? 0 : 2;
+}
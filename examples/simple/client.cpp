@@ -7,14 +7,15 @@
 
 int main(int argc, char* argv[]) {
     // Load configuration
-    ClientConfig config("client.json");
+    ClientConfig config(argc > 1 ? argv[1] : "client.json");
     
     // Generate Ed25519 keypair
     auto keypair = SignatureUtils::generateKeyPair();
     
     // Create client instance
     // Args: server_host, server_port, listen_host, listen_port, private_key, public_key, config
-    TribuneClient client("localhost", 8080, "localhost", 0, 
+    TribuneClient client(config.server_host, config.server_port,
+                        config.listen_host, config.listen_port,
                         keypair.second, keypair.first, config);
     
     // Register MPC modules
@@ -4,18 +4,18 @@
 #include <memory>
 
 int main(int argc, char* argv[]) {
-    // Load configuration
-    ServerConfig config("server.json");
+    // Load configuration (pass a path to run several shards side by side)
+    ServerConfig config(argc > 1 ? argv[1] : "server.json");
     
     // Create server instance
-    TribuneServer server("localhost", 8080, config);
+    TribuneServer server(config.host, config.port, config);
     
     // Register MPC modules
     auto secure_sum = std::make_unique<SecureSumModule>();
     server.registerModule("secure_sum", std::move(secure_sum));
     
     std::cout << "Starting Tribune server with Secure Sum module..." << std::endl;
-    std::cout << "Listening on localhost:8080" << std::endl;
+    std::cout << "Listening on " << config.host << ":" << config.port << std::endl;
     
     // Start the server (blocks)
     server.start();
@@ -12,11 +12,16 @@ struct ClientConfig {
   // Client network settings
   std::string listen_host;
   int listen_port;
+  std::string transport; // "httplib" (thread pool) or "epoll" (Linux only)
   
   // Health monitoring
   int health_check_interval_seconds;
   int server_timeout_seconds;
   
+  // Event retention
+  int event_retention_seconds; // How long an event's state is kept after it is announced (>= the server's event_timeout_boundary)
+  int max_retained_events;     // Oldest finished events are evicted beyond this
+  
   // Connection settings
   int connection_timeout_seconds;
   int read_timeout_seconds;
@@ -31,8 +36,11 @@ struct ClientConfig {
     server_port = 8080;
     listen_host = "localhost";
     listen_port = 0; // Auto-assign
+    transport = "httplib";
     health_check_interval_seconds = 10;
     server_timeout_seconds = 30;
+    event_retention_seconds = 120; // The server's default event_timeout_boundary
+    max_retained_events = 1024;
     connection_timeout_seconds = 2;
     read_timeout_seconds = 5;
     use_tls = false;
@@ -49,8 +57,11 @@ struct ClientConfig {
         if (config.contains("server_port")) server_port = config["server_port"];
         if (config.contains("listen_host")) listen_host = config["listen_host"];
         if (config.contains("listen_port")) listen_port = config["listen_port"];
+        if (config.contains("transport")) transport = config["transport"];
         if (config.contains("health_check_interval_seconds")) health_check_interval_seconds = config["health_check_interval_seconds"];
         if (config.contains("server_timeout_seconds")) server_timeout_seconds = config["server_timeout_seconds"];
+        if (config.contains("event_retention_seconds")) event_retention_seconds = config["event_retention_seconds"];
+        if (config.contains("max_retained_events")) max_retained_events = config["max_retained_events"];
         if (config.contains("connection_timeout_seconds")) connection_timeout_seconds = config["connection_timeout_seconds"];
         if (config.contains("read_timeout_seconds")) read_timeout_seconds = config["read_timeout_seconds"];
         if (config.contains("use_tls")) use_tls = config["use_tls"];
@@ -83,6 +94,14 @@ private:
       throw std::invalid_argument("Invalid server_timeout_seconds: " + std::to_string(server_timeout_seconds) + ". Must be >= health_check_interval_seconds (" + std::to_string(health_check_interval_seconds) + ")");
     }
     
+    if (event_retention_seconds < 1) {
+      throw std::invalid_argument("Invalid event_retention_seconds: " + std::to_string(event_retention_seconds) + ". Must be >= 1");
+    }
+    
+    if (max_retained_events < 1) {
+      throw std::invalid_argument("Invalid max_retained_events: " + std::to_string(max_retained_events) + ". Must be >= 1");
+    }
+    
     if (connection_timeout_seconds < 1) {
       throw std::invalid_argument("Invalid connection_timeout_seconds: " + std::to_string(connection_timeout_seconds) + ". Must be >= 1");
     }
@@ -98,6 +117,15 @@ private:
     if (listen_host.empty()) {
       throw std::invalid_argument("Listen host cannot be empty");
     }
+
+    if (transport != "httplib" && transport != "epoll") {
+      throw std::invalid_argument("Invalid transport: " + transport + ". Must be \"httplib\" or \"epoll\"");
+    }
+#ifndef __linux__
+    if (transport == "epoll") {
+      throw std::invalid_argument("The epoll transport is only available on Linux");
+    }
+#endif
   }
 };
 
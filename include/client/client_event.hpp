@@ -0,0 +1,84 @@
+#pragma once
+#include "event_arena.hpp"
+#include "event_lifecycle.hpp"
+#include "events/events.hpp"
+#include "mpc/mpc_module.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Everything a client holds for one event. The Event itself is immutable
+// once stored; shards and lifecycle state are guarded by the event's own
+// mutex, so shards for unrelated events never contend.
+class ClientEvent {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ClientEvent(Event event, std::shared_ptr<MPCModule> module,
+              Clock::time_point expires);
+
+  ClientEvent(const ClientEvent &) = delete;
+  ClientEvent &operator=(const ClientEvent &) = delete;
+
+  const Event event;
+  const size_t event_bytes; // Approximate heap footprint of event
+  // Module for event.computation_type, resolved once when the event was
+  // tracked; null if none was registered
+  const std::shared_ptr<MPCModule> module;
+
+  // Position of client_id in event.participants
+  std::optional<size_t> participantIndex(const std::string &client_id) const;
+
+  // Stores the shard of the participant at index. Returns true only for the
+  // arrival that completes the set of participants' shards. Shards arriving after releaseShards() are
+  // dropped, but still count towards completeness.
+  bool storeShard(size_t index, std::string_view data);
+  // Lock-free; a counter, not a scan over participants
+  bool hasAllShards() const {
+    return shards_received_.load(std::memory_order_acquire) ==
+           event.participants.size();
+  }
+  // Views of the received shards in participant order, for the module.
+  // Freezes the shards: later arrivals are dropped, so the views stay valid
+  // until releaseShards(). Empty once the shards are released.
+  std::span<const ShardView> freezeShards();
+  // Drops the shard arena; the shards are not needed after computing
+  void releaseShards();
+  size_t arenaBytes() const;
+
+  // True for exactly one caller, which then runs the computation
+  bool tryStartComputing() { return !computing_claimed_.exchange(true); }
+
+  // Lifecycle. Phases only move forward, except expireNow().
+  EventPhase phase() const;
+  void advance(EventPhase phase);
+  void expireNow(Clock::time_point now);
+  Clock::time_point expires() const;
+  void setExpires(Clock::time_point expires);
+
+private:
+  std::unordered_map<std::string, size_t> participant_index_;
+  std::atomic<bool> computing_claimed_{false};
+
+  // Bit i set once participant i's shard arrived; shards_received_ counts
+  // the set bits, so completeness is one load
+  std::unique_ptr<std::atomic<uint64_t>[]> received_bits_;
+  std::atomic<size_t> shards_received_{0};
+  // Shards received including this one, or 0 if it was a resend
+  size_t markReceived(size_t index);
+
+  mutable std::mutex mutex_;
+  std::unique_ptr<EventArena> arena_; // Null once released
+  bool shards_frozen_ = false;
+  std::vector<ShardView> shard_views_; // Reserved up front for every participant
+  EventPhase phase_ = EventPhase::Announced;
+  Clock::time_point expires_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <httplib.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Single-threaded, edge-triggered epoll HTTP/1.1 listener for the client's
+// inbound endpoints (/event, /ping, /peer-data). It mirrors the subset of
+// httplib::Server the client uses, so routes are registered with the same
+// handler callbacks. Only plain HTTP with Content-Length bodies is supported.
+//
+// Handlers run on the event loop thread and must not block on network I/O;
+// anything slow should be handed off to another thread.
+//
+// Linux only: on other platforms bind_to_port() fails.
+class EpollTransport {
+public:
+  using Handler = httplib::Server::Handler;
+
+  EpollTransport();
+  ~EpollTransport();
+
+  EpollTransport(const EpollTransport &) = delete;
+  EpollTransport &operator=(const EpollTransport &) = delete;
+
+  EpollTransport &Post(const std::string &path, Handler handler);
+
+  bool bind_to_port(const std::string &host, int port);
+  bool listen_after_bind();
+  bool listen(const std::string &host, int port);
+  void stop();
+  bool is_running() const { return running_; }
+
+  // Idle keep-alive connections are closed after this long
+  void set_keep_alive_timeout(std::chrono::seconds timeout) {
+    keep_alive_timeout_ = timeout;
+  }
+  // Requests with larger bodies are rejected with 413
+  void set_payload_max_length(size_t length) { payload_max_length_ = length; }
+
+private:
+  struct Connection {
+    int fd = -1;
+    std::string remote_addr;
+    int remote_port = -1;
+    std::string in;  // Unparsed request bytes
+    std::string out; // Pending response bytes
+    size_t out_offset = 0;
+    bool close_after_write = false;
+    std::chrono::steady_clock::time_point last_active;
+  };
+
+  static constexpr size_t MAX_HEADER_BYTES = 8192;
+  static constexpr int MAX_EVENTS = 64;
+
+  void acceptConnections();
+  void handleReadable(Connection &conn);
+  void handleWritable(Connection &conn);
+  // Parses and dispatches every complete request buffered on the connection.
+  // Returns false if the connection must be closed once output is flushed.
+  bool processRequests(Connection &conn);
+  void dispatch(const httplib::Request &req, httplib::Response &res);
+  void appendResponse(Connection &conn, const httplib::Response &res,
+                      bool keep_alive);
+  void closeConnection(int fd);
+  void closeIdleConnections();
+
+  std::unique_ptr<Connection> acquireConnection();
+  void releaseConnection(std::unique_ptr<Connection> conn);
+
+  int listen_fd_ = -1;
+  int epoll_fd_ = -1;
+  int wake_fd_ = -1;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stop_requested_{false}; // Sticky, so an early stop() wins
+
+  std::unordered_map<std::string, Handler> post_handlers_;
+  std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+  // Closed connections keep their buffers for reuse by the next accept
+  std::vector<std::unique_ptr<Connection>> free_connections_;
+  std::vector<char> read_buffer_;
+
+  std::chrono::seconds keep_alive_timeout_{5};
+  size_t payload_max_length_ = 64 * 1024 * 1024;
+};
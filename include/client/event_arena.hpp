@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Event-scoped client storage. An event's shards are bump-allocated from one
+// monotonic arena instead of the global heap, and the whole arena is released
+// in one shot when the event is retired. Individual entries are never freed
+// before then.
+//
+// Shards sit in one slot per participant, indexed by the participant's
+// position in the event; which slots are filled is tracked by the owner.
+//
+// Not thread-safe; guarded by the owning ClientEvent's mutex.
+class EventArena {
+public:
+  using ShardSlots = std::pmr::vector<std::pmr::string>;
+
+  // Sized for a handful of participants' shards before the first refill
+  static constexpr size_t INITIAL_BYTES = 16 * 1024;
+
+  explicit EventArena(size_t slots)
+      : resource_(INITIAL_BYTES, &upstream_), shards_(slots, &resource_) {}
+
+  EventArena(const EventArena &) = delete;
+  EventArena &operator=(const EventArena &) = delete;
+
+  // A resend replaces the slot's previous data
+  void storeShard(size_t slot, std::string_view data) {
+    shards_[slot].assign(data);
+  }
+
+  const ShardSlots &shards() const { return shards_; }
+
+  // For event-scoped scratch containers that should share the arena
+  std::pmr::memory_resource *resource() { return &resource_; }
+
+  // Heap memory held by the arena, including unused tail space
+  size_t bytesReserved() const { return upstream_.bytes(); }
+
+private:
+  // Counts the blocks the arena takes from the heap
+  class CountingResource : public std::pmr::memory_resource {
+  public:
+    size_t bytes() const { return bytes_; }
+
+  private:
+    void *do_allocate(size_t bytes, size_t alignment) override {
+      void *p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+      bytes_ += bytes;
+      return p;
+    }
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override {
+      std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+      bytes_ -= bytes;
+    }
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+      return this == &other;
+    }
+
+    size_t bytes_ = 0;
+  };
+
+  CountingResource upstream_;
+  std::pmr::monotonic_buffer_resource resource_; // Must outlive shards_
+  ShardSlots shards_;
+};
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+// Where an event stands on this client. Events move forward only:
+//   Announced -> Sharing -> Computing -> Submitted -> Expired
+// Expired events are evicted, with all their state, once their retention
+// deadline passes or when the client holds more than max_retained_events.
+enum class EventPhase { Announced = 0, Sharing, Computing, Submitted, Expired };
+
+constexpr size_t EVENT_PHASE_COUNT = 5;
+
+inline const char *toString(EventPhase phase) {
+  switch (phase) {
+  case EventPhase::Announced:
+    return "announced";
+  case EventPhase::Sharing:
+    return "sharing";
+  case EventPhase::Computing:
+    return "computing";
+  case EventPhase::Submitted:
+    return "submitted";
+  case EventPhase::Expired:
+    return "expired";
+  }
+  return "unknown";
+}
+
+// Snapshot of the client's retained event state
+struct ClientEventStats {
+  size_t retained_events = 0;
+  std::array<size_t, EVENT_PHASE_COUNT> events_by_phase{}; // Indexed by EventPhase
+  uint64_t expired_total = 0;        // Evicted at their retention deadline
+  uint64_t evicted_over_capacity = 0; // Evicted early to honor max_retained_events
+  size_t event_bytes = 0;            // Approximate size of the retained Event copies
+  size_t arena_bytes = 0;            // Heap held by per-event shard arenas
+};
+
+inline void to_json(nlohmann::json &j, const ClientEventStats &s) {
+  nlohmann::json phases = nlohmann::json::object();
+  for (size_t i = 0; i < EVENT_PHASE_COUNT; i++) {
+    phases[toString(static_cast<EventPhase>(i))] = s.events_by_phase[i];
+  }
+  j = nlohmann::json{{"retained_events", s.retained_events},
+                     {"events_by_phase", phases},
+                     {"expired_total", s.expired_total},
+                     {"evicted_over_capacity", s.evicted_over_capacity},
+                     {"event_bytes", s.event_bytes},
+                     {"arena_bytes", s.arena_bytes}};
+}
@@ -1,10 +1,18 @@
 #pragma once
 #include "client_config.hpp"
+#include "client_event.hpp"
 #include "crypto/signature.hpp"
 #include "data_collection_module.hpp"
+#include "epoll_transport.hpp"
+#include "event_lifecycle.hpp"
+#include "events/aggregation_tree.hpp"
 #include "events/events.hpp"
-#include "mpc/mpc_module.hpp"
+#include "mpc/module_registry.hpp"
+#include "utils/bounded_task_queue.hpp"
+#include "utils/concurrent_map.hpp"
 #include "utils/connection_pool.hpp"
+#include "utils/deadline_queue.hpp"
+#include "utils/dedup_filter.hpp"
 #include <atomic>
 #include <chrono>
 #include <httplib.h>
@@ -37,6 +45,12 @@ public:
   // MPC module management
   void registerModule(const std::string &type,
                      std::unique_ptr<MPCModule> module);
+  // Registers a concrete module type, e.g.
+  // registerModule<SecureSum<Fp61>>("secure_sum_fp61")
+  template <typename Module, typename... Args>
+  std::shared_ptr<Module> registerModule(const std::string &type, Args &&...args) {
+    return modules_.emplace<Module>(type, std::forward<Args>(args)...);
+  }
 
   // Event handling
   void onEventAnnouncement(const Event &event, bool relay = true);
@@ -51,6 +65,9 @@ public:
   const std::string &getListenHost() const { return listen_host_; }
   bool isServerAlive() const { return server_alive_; }
 
+  // Retained per-event state, for watching a long-running client's memory
+  ClientEventStats getEventStats();
+
 private:
   // Client identification
   std::string client_id_;
@@ -73,6 +90,12 @@ private:
   std::thread listener_thread_;
   std::atomic<bool> running_;
   httplib::Server event_server_;
+  std::unique_ptr<EpollTransport> epoll_transport_; // Set when transport is "epoll"
+  // With epoll, blocking handler work (peer fan-out, forwarding partials)
+  // runs here rather than on the event loop; stop() drains and joins it
+  static constexpr size_t EPOLL_WORKER_THREADS = 4;
+  static constexpr size_t EPOLL_MAX_QUEUED_JOBS = 1024;
+  std::unique_ptr<BoundedTaskQueue> epoll_workers_;
   
   // Server health monitoring
   std::atomic<bool> server_alive_{true};
@@ -80,14 +103,21 @@ private:
   ConnectionPool connection_pool_;
   void periodicHealthChecker();
 
-  // Active events we're participating in (read-heavy: status checks, data collection)
-  std::unordered_map<std::string, Event> active_events_;
-  std::shared_mutex active_events_mutex_;
-
-  // Shards storage: <event_id, <client_id, data>> (read-heavy: completion checks)
-  std::unordered_map<std::string, std::unordered_map<std::string, std::string>>
-      event_shards_;
-  std::shared_mutex event_shards_mutex_;
+  // Every event this client holds state for, each with its own lock, so
+  // shards for independent events are ingested without contending.
+  // evictEvent() drops an event together with its tree_aggregations_ entry.
+  ConcurrentMap<std::string, std::shared_ptr<ClientEvent>> events_;
+  DeadlineQueue<std::string> event_expiry_;
+  std::thread expiry_thread_;
+  std::atomic<uint64_t> events_expired_{0};
+  std::atomic<uint64_t> events_evicted_{0};
+  // Returns the stored event, which is the earlier copy if it was re-announced
+  std::shared_ptr<ClientEvent> trackEvent(const Event &event);
+  void expireEvent(ClientEvent &client_event); // Evict at the next expiry pass
+  // Events that are computing are kept; at_deadline evictions only happen
+  // once the retention deadline has passed
+  bool evictEvent(const std::string &event_id, bool at_deadline);
+  void eventExpiryLoop();
 
   // Note: Orphan shards are no longer needed with peer event propagation
 
@@ -95,35 +125,54 @@ private:
   std::unique_ptr<DataCollectionModule> data_module_;
   std::mutex data_module_mutex_;
 
-  // MPC modules
-  std::unordered_map<std::string, std::unique_ptr<MPCModule>>
-      modules_;
-  std::shared_mutex modules_mutex_;
+  // MPC modules; each event binds its module when it is first tracked
+  ModuleRegistry modules_;
   
-  // Track events currently being computed to prevent duplicate computation threads
-  std::unordered_set<std::string> computing_events_;
-  std::mutex computing_events_mutex_;
-
-  // TTL-based deduplication for broadcast storm prevention (read-heavy: duplicate checks)
-  struct RecentItem {
-    std::chrono::steady_clock::time_point received_time;
-  };
-  std::unordered_map<std::string, RecentItem> recent_events_;
-  std::unordered_map<std::string, RecentItem>
-      recent_shards_; // event_id + "|" + client_id
-  std::shared_mutex recent_items_mutex_;
-  int cleanup_counter_ = 0; // Counter for periodic cleanup
+  // TTL-based deduplication of (event_id, from_client) shard hashes for
+  // broadcast storm prevention
   static constexpr int RECENT_ITEMS_TTL_SECONDS = 60; // 2x event timeout
   static constexpr int EVENT_TIMEOUT_SECONDS = 30;    // Match server timeout
-  static constexpr int CLEANUP_FREQUENCY = 50; // Clean up every N peer messages
+  RotatingDedupFilter recent_shards_{std::chrono::seconds(RECENT_ITEMS_TTL_SECONDS)};
+
+  // Aggregation tree events: partials of our subtree (our own plus what our
+  // children forwarded) waiting to be combined and sent to our parent
+  struct TreeAggregation {
+    std::vector<TreePartial> bundle;
+    std::unordered_set<std::string> reported_children;
+    size_t children_pending = 0;
+    bool own_partial = false;
+    bool forwarded = false;
+    std::chrono::system_clock::time_point deadline;
+  };
+  std::unordered_map<std::string, TreeAggregation> tree_aggregations_;
+  std::mutex tree_aggregations_mutex_;
+  // Forward deadlines of pending tree aggregations, serviced by one thread
+  DeadlineQueue<std::string> tree_deadlines_;
+  std::thread tree_flush_thread_;
+  void treeFlushLoop();
 
   // Private methods
   void runEventListener();
   void setupEventRoutes();
-  void computeAndSubmitResult(const std::string &event_id);
-  std::string runComputation(const std::string &event_id);
-  bool submitResult(const std::string &event_id, const std::string &result);
-  bool hasAllShards(const std::string &event_id);
-  void cleanupRecentItems();
+  void addEventRoute(const std::string &path, httplib::Server::Handler handler);
+  // Runs the computation on a detached thread unless one already has
+  void startComputation(std::shared_ptr<ClientEvent> client_event);
+  void computeAndSubmitResult(std::shared_ptr<ClientEvent> client_event);
+  // For modules that submit directly: mask our input and submit it
+  void submitMaskedInput(std::shared_ptr<ClientEvent> client_event,
+                         const std::string &my_data);
+  // Sends our partial up the aggregation tree or to the server
+  void submitPartial(ClientEvent &client_event, const std::string &result);
+  std::string runComputation(ClientEvent &client_event);
+  bool submitResult(const Event &event, const std::string &result);
+  // Validates a child's forwarded bundle; returns the HTTP status to reply with
+  int verifyTreePartial(const TreePartialMessage &msg,
+                        std::shared_ptr<ClientEvent> &client_event);
+  void addTreePartials(const ClientEvent &client_event,
+                       const std::string &from_client,
+                       std::vector<TreePartial> partials);
+  void flushTreePartials(const std::string &event_id);
+  void forwardTreePartials(const ClientEvent &client_event,
+                           std::vector<TreePartial> bundle);
   bool verifyEventFromServer(const Event &event);
 };
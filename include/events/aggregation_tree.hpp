@@ -0,0 +1,114 @@
+#pragma once
+#include "events/events.hpp"
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Topology of a hierarchical aggregation event, announced through
+// computation_metadata["aggregation_tree"] = {"fan_in": F, "level_timeout_ms": T}.
+//
+// Participants form an F-ary heap under the server in participant order:
+// participant i (0-based) sits at position p = i + 1, its parent is position
+// (p - 1) / F and position 0 is the server. Each participant combines its
+// own partial with its children's and forwards one bundle upward, so the
+// server receives at most F submissions per event.
+struct AggregationTree {
+  static constexpr size_t SERVER = static_cast<size_t>(-1);
+
+  size_t fan_in = 0;
+  size_t size = 0; // Number of participants
+  std::chrono::milliseconds level_timeout{0};
+
+  static std::optional<AggregationTree> of(const Event &event) {
+    auto it = event.computation_metadata.find("aggregation_tree");
+    if (it == event.computation_metadata.end() || !it->is_object()) {
+      return std::nullopt;
+    }
+    AggregationTree tree;
+    tree.fan_in = it->value("fan_in", size_t{0});
+    tree.size = event.participants.size();
+    tree.level_timeout = std::chrono::milliseconds(it->value("level_timeout_ms", 5000));
+    if (tree.fan_in < 2) {
+      return std::nullopt;
+    }
+    return tree;
+  }
+
+  // Participant index of the parent, or SERVER for top-level participants
+  size_t parentOf(size_t index) const {
+    size_t parent_position = index / fan_in; // (p - 1) / F with p = index + 1
+    return parent_position == 0 ? SERVER : parent_position - 1;
+  }
+
+  std::vector<size_t> childrenOf(size_t index) const {
+    std::vector<size_t> children;
+    size_t first = (index + 1) * fan_in; // Position F*p + 1 as an index
+    for (size_t c = first; c < std::min(first + fan_in, size); c++) {
+      children.push_back(c);
+    }
+    return children;
+  }
+
+  // Top-level participants are at depth 0
+  size_t depthOf(size_t index) const {
+    size_t depth = 0;
+    for (size_t parent = parentOf(index); parent != SERVER; parent = parentOf(parent)) {
+      depth++;
+    }
+    return depth;
+  }
+
+  size_t height() const { return size == 0 ? 0 : depthOf(size - 1); }
+  size_t topLevelCount() const { return std::min(fan_in, size); }
+
+  // How long after the event was created a participant forwards whatever it
+  // has: deeper levels go first, so each level has waited one level_timeout
+  // longer than the one below it
+  std::chrono::milliseconds forwardDeadline(size_t index) const {
+    return level_timeout * static_cast<int64_t>(height() - depthOf(index) + 1);
+  }
+};
+
+// One entry of a forwarded bundle: a participant's partial, or a partial
+// already combined from the listed contributors
+struct TreePartial {
+  std::string participant_id;
+  nlohmann::json value;
+  std::vector<std::string> contributors;
+};
+
+inline void to_json(nlohmann::json &j, const TreePartial &t) {
+  j = nlohmann::json{{"participant_id", t.participant_id},
+                     {"value", t.value},
+                     {"contributors", t.contributors}};
+}
+
+inline void from_json(const nlohmann::json &j, TreePartial &t) {
+  j.at("participant_id").get_to(t.participant_id);
+  t.value = j.at("value");
+  j.at("contributors").get_to(t.contributors);
+}
+
+// Sent from a participant to its parent's /partial endpoint
+struct TreePartialMessage {
+  std::string event_id;
+  std::string from_client;
+  std::vector<TreePartial> bundle;
+  std::string signature; // Ed25519 signature of (event_id|from_client|bundle JSON)
+};
+
+inline void to_json(nlohmann::json &j, const TreePartialMessage &m) {
+  j = nlohmann::json{{"event_id", m.event_id},
+                     {"from_client", m.from_client},
+                     {"bundle", m.bundle},
+                     {"signature", m.signature}};
+}
+
+inline void from_json(const nlohmann::json &j, TreePartialMessage &m) {
+  j.at("event_id").get_to(m.event_id);
+  j.at("from_client").get_to(m.from_client);
+  j.at("bundle").get_to(m.bundle);
+  j.at("signature").get_to(m.signature);
+}
@@ -29,6 +29,7 @@ struct Event {
   std::vector<ClientInfo> participants;
   std::string server_signature;  // Server signature for verification
   std::chrono::time_point<std::chrono::system_clock> timestamp;  // Event creation time
+  std::string aggregator;  // "host:port" of the shard collecting results; empty = the client's own server
   
   Event() : timestamp(std::chrono::system_clock::now()), computation_metadata(nlohmann::json::object()) {}
   
@@ -105,6 +106,9 @@ inline void to_json(nlohmann::json &j, const Event &e) {
     {"timestamp", std::chrono::duration_cast<std::chrono::milliseconds>(
                       e.timestamp.time_since_epoch()).count()}
   };
+  if (!e.aggregator.empty()) {
+    j["aggregator"] = e.aggregator;
+  }
 }
 
 inline void from_json(const nlohmann::json &j, Event &e) {
@@ -129,6 +133,27 @@ inline void from_json(const nlohmann::json &j, Event &e) {
     e.timestamp = std::chrono::system_clock::time_point(
         std::chrono::milliseconds(timestamp_ms));
   }
+  
+  if (j.contains("aggregator")) {
+    j.at("aggregator").get_to(e.aggregator);
+  }
+}
+
+// Message the server signs for an event. The aggregator is covered so a
+// relayed event cannot redirect participants' results elsewhere.
+inline std::string eventSignaturePayload(const Event &e) {
+  std::string payload = e.event_id + "|" + e.computation_type + "|" +
+                        std::to_string(e.participants.size());
+  if (!e.aggregator.empty()) {
+    payload += "|" + e.aggregator;
+  }
+  // Participants route partials to each other along the tree, so its shape
+  // must come from the server
+  auto tree = e.computation_metadata.find("aggregation_tree");
+  if (tree != e.computation_metadata.end()) {
+    payload += "|" + tree->dump();
+  }
+  return payload;
 }
 
 // JSON conversion functions for EventResponse
@@ -0,0 +1,221 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <sodium.h>
+
+// Element types for secret sharing. Each type provides +, -, * and
+// FieldTraits<T> to convert from uint64_t, to draw uniformly random
+// elements, and to write an element as LIMBS 64-bit words on the wire (low
+// word first); modules templated on the element type inline all of it. The
+// prime fields also provide inverse(). FieldOps (field_ops.hpp) runs the
+// arithmetic over arrays and FieldVector (field_vector.hpp) encodes them.
+
+// Element of GF(2^61 - 1). Kept reduced to [0, P).
+struct Fp61 {
+    static constexpr uint64_t P = (uint64_t{1} << 61) - 1;
+
+    uint64_t v = 0;
+
+    static constexpr Fp61 reduce(uint64_t x) {
+        // x = hi * 2^61 + lo and 2^61 = 1 (mod P)
+        uint64_t r = (x & P) + (x >> 61);
+        return Fp61{r >= P ? r - P : r};
+    }
+
+    friend constexpr Fp61 operator+(Fp61 a, Fp61 b) {
+        uint64_t r = a.v + b.v;  // < 2^62, no overflow
+        return Fp61{r >= P ? r - P : r};
+    }
+    friend constexpr Fp61 operator-(Fp61 a, Fp61 b) {
+        return Fp61{a.v >= b.v ? a.v - b.v : a.v + P - b.v};
+    }
+    friend constexpr Fp61 operator*(Fp61 a, Fp61 b) {
+        unsigned __int128 x = static_cast<unsigned __int128>(a.v) * b.v;  // < 2^122
+        uint64_t r = (static_cast<uint64_t>(x) & P) + static_cast<uint64_t>(x >> 61);
+        return Fp61{r >= P ? r - P : r};
+    }
+    Fp61& operator+=(Fp61 b) { return *this = *this + b; }
+    Fp61& operator-=(Fp61 b) { return *this = *this - b; }
+    Fp61& operator*=(Fp61 b) { return *this = *this * b; }
+    friend constexpr bool operator==(Fp61 a, Fp61 b) { return a.v == b.v; }
+
+    constexpr Fp61 pow(uint64_t e) const {
+        Fp61 result{1}, base = *this;
+        for (; e != 0; e >>= 1) {
+            if (e & 1) result = result * base;
+            base = base * base;
+        }
+        return result;
+    }
+    // Zero has no inverse and maps to zero
+    constexpr Fp61 inverse() const { return pow(P - 2); }
+};
+
+// Element of GF(P) for an odd prime P < 2^127, for when 61 bits are not
+// enough headroom. Kept in Montgomery form (x * 2^128 mod P), so a product
+// costs four 64-bit multiplies and one reduction instead of a 256-bit
+// division.
+template <unsigned __int128 Modulus>
+struct Fp128 {
+    using u128 = unsigned __int128;
+    static_assert(Modulus % 2 == 1 && (Modulus >> 127) == 0,
+                  "Fp128 needs an odd modulus below 2^127");
+    static constexpr u128 P = Modulus;
+
+    u128 v = 0;  // Montgomery form, in [0, P)
+
+    static constexpr Fp128 fromU128(u128 x) { return Fp128{mulReduce(x % P, R2)}; }
+    constexpr u128 toU128() const { return reduce(0, v); }
+
+    friend constexpr Fp128 operator+(Fp128 a, Fp128 b) {
+        u128 r = a.v + b.v;  // < 2^128, no overflow
+        return Fp128{r >= P ? r - P : r};
+    }
+    friend constexpr Fp128 operator-(Fp128 a, Fp128 b) {
+        return Fp128{a.v >= b.v ? a.v - b.v : a.v + P - b.v};
+    }
+    friend constexpr Fp128 operator*(Fp128 a, Fp128 b) { return Fp128{mulReduce(a.v, b.v)}; }
+    Fp128& operator+=(Fp128 b) { return *this = *this + b; }
+    Fp128& operator-=(Fp128 b) { return *this = *this - b; }
+    Fp128& operator*=(Fp128 b) { return *this = *this * b; }
+    friend constexpr bool operator==(Fp128 a, Fp128 b) { return a.v == b.v; }
+
+    constexpr Fp128 pow(u128 e) const {
+        Fp128 result{R}, base = *this;
+        for (; e != 0; e >>= 1) {
+            if (e & 1) result = result * base;
+            base = base * base;
+        }
+        return result;
+    }
+    // Zero has no inverse and maps to zero
+    constexpr Fp128 inverse() const { return pow(P - 2); }
+
+private:
+    // -P^-1 mod 2^128 by Newton's iteration; each step doubles the correct bits
+    static constexpr u128 NEG_INV = [] {
+        u128 inv = P;  // Correct to 3 bits for odd P
+        for (int i = 0; i < 7; i++) {
+            inv *= 2 - P * inv;
+        }
+        return -inv;
+    }();
+    static constexpr u128 R = (u128{0} - P) % P;  // 2^128 mod P, one in Montgomery form
+    static constexpr u128 R2 = [] {
+        u128 r = R;
+        for (int i = 0; i < 128; i++) {
+            r = r + r >= P ? r + r - P : r + r;
+        }
+        return r;
+    }();
+
+    // Montgomery reduction of hi * 2^128 + lo, for hi < P
+    static constexpr u128 reduce(u128 hi, u128 lo) {
+        u128 m = lo * NEG_INV;
+        u128 m_hi, m_lo;
+        mulWide(m, P, m_hi, m_lo);
+        // lo + m_lo is 0 mod 2^128 by construction; it carries unless lo is 0
+        u128 r = hi + m_hi + (lo != 0);  // < 2P
+        return r >= P ? r - P : r;
+    }
+    static constexpr u128 mulReduce(u128 a, u128 b) {
+        u128 hi, lo;
+        mulWide(a, b, hi, lo);
+        return reduce(hi, lo);
+    }
+    static constexpr void mulWide(u128 a, u128 b, u128& hi, u128& lo) {
+        uint64_t a0 = static_cast<uint64_t>(a), a1 = static_cast<uint64_t>(a >> 64);
+        uint64_t b0 = static_cast<uint64_t>(b), b1 = static_cast<uint64_t>(b >> 64);
+        u128 p00 = u128{a0} * b0, p01 = u128{a0} * b1;
+        u128 p10 = u128{a1} * b0, p11 = u128{a1} * b1;
+        u128 mid = (p00 >> 64) + static_cast<uint64_t>(p01) + static_cast<uint64_t>(p10);
+        lo = (mid << 64) | static_cast<uint64_t>(p00);
+        hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+    }
+};
+
+// The Mersenne prime 2^127 - 1
+using Fp127 = Fp128<(static_cast<unsigned __int128>(1) << 127) - 1>;
+
+template <typename T>
+struct FieldTraits;
+
+// The ring Z/2^64: plain unsigned arithmetic wraps
+template <>
+struct FieldTraits<uint64_t> {
+    static constexpr const char* name = "ring64";
+    static constexpr size_t LIMBS = 1;
+    static uint64_t fromUint64(uint64_t x) { return x; }
+    static uint64_t toUint64(uint64_t x) { return x; }
+    static uint64_t fromLimbs(const uint64_t* in) { return in[0]; }
+    static void toLimbs(uint64_t x, uint64_t* out) { out[0] = x; }
+    static uint64_t random() {
+        uint64_t x;
+        randombytes_buf(&x, sizeof(x));
+        return x;
+    }
+    static void randomFill(std::span<uint64_t> out) {
+        randombytes_buf(out.data(), out.size_bytes());
+    }
+};
+
+template <>
+struct FieldTraits<Fp61> {
+    static constexpr const char* name = "fp61";
+    static constexpr size_t LIMBS = 1;
+    static Fp61 fromUint64(uint64_t x) { return Fp61::reduce(x); }
+    static uint64_t toUint64(Fp61 x) { return x.v; }
+    static Fp61 fromLimbs(const uint64_t* in) { return Fp61::reduce(in[0]); }
+    static void toLimbs(Fp61 x, uint64_t* out) { out[0] = x.v; }
+    static Fp61 random() {
+        // Rejection sampling over 61 bits keeps the draw uniform
+        uint64_t x;
+        do {
+            randombytes_buf(&x, sizeof(x));
+            x &= Fp61::P;
+        } while (x == Fp61::P);
+        return Fp61{x};
+    }
+    // One randombytes_buf call for the whole span; the rare P redraws singly
+    static void randomFill(std::span<Fp61> out) {
+        randombytes_buf(out.data(), out.size_bytes());
+        for (auto& x : out) {
+            x.v &= Fp61::P;
+            if (x.v == Fp61::P) x = random();
+        }
+    }
+};
+
+template <unsigned __int128 Modulus>
+struct FieldTraits<Fp128<Modulus>> {
+    using Fp = Fp128<Modulus>;
+    static constexpr const char* name = "fp128";
+    static constexpr size_t LIMBS = 2;
+    static Fp fromUint64(uint64_t x) { return Fp::fromU128(x); }
+    static Fp fromLimbs(const uint64_t* in) {
+        return Fp::fromU128(static_cast<unsigned __int128>(in[1]) << 64 | in[0]);
+    }
+    static void toLimbs(Fp x, uint64_t* out) {
+        unsigned __int128 v = x.toU128();
+        out[0] = static_cast<uint64_t>(v);
+        out[1] = static_cast<uint64_t>(v >> 64);
+    }
+    static Fp random() {
+        // Rejection sampling over the bit length of P keeps the draw uniform
+        constexpr uint64_t hi = static_cast<uint64_t>(Fp::P >> 64);
+        constexpr int bits = hi != 0 ? 128 - std::countl_zero(hi)
+                                     : 64 - std::countl_zero(static_cast<uint64_t>(Fp::P));
+        constexpr unsigned __int128 mask = (static_cast<unsigned __int128>(1) << bits) - 1;
+        unsigned __int128 x;
+        do {
+            randombytes_buf(&x, sizeof(x));
+            x &= mask;
+        } while (x >= Fp::P);
+        return Fp::fromU128(x);
+    }
+    static void randomFill(std::span<Fp> out) {
+        for (auto& x : out) x = random();
+    }
+};
@@ -0,0 +1,260 @@
+#pragma once
+#include "field.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TRIBUNE_FIELD_SIMD 1
+#endif
+
+// Element-wise field arithmetic over arrays, for the inner loops of sharing
+// and reconstruction. For uint64_t (Z/2^64) and Fp61 the loops run AVX-512 or
+// AVX2 kernels picked at runtime, with a scalar fallback that also handles
+// the tail. Fp128 and other element types always take the scalar loop, which
+// inlines their operators.
+//
+// Every operation updates acc in place from b, which must be at least as long
+// as acc, and gives the same result on every kernel.
+enum class SimdLevel { Scalar, Avx2, Avx512 };
+
+inline const char* toString(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::Avx2: return "avx2";
+    case SimdLevel::Avx512: return "avx512";
+    }
+    return "unknown";
+}
+
+class FieldOps {
+public:
+    enum class Op {
+        Add,     // acc + b
+        Sub,     // acc - b
+        Mul,     // acc * b
+        MulAdd,  // acc * c + b, a Horner step
+        Axpy,    // acc + c * b
+    };
+
+    // The best kernel this CPU runs
+    static SimdLevel detectedSimd() {
+#ifdef TRIBUNE_FIELD_SIMD
+        static const SimdLevel level = __builtin_cpu_supports("avx512f") ? SimdLevel::Avx512
+                                       : __builtin_cpu_supports("avx2")  ? SimdLevel::Avx2
+                                                                         : SimdLevel::Scalar;
+        return level;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }
+
+    template <typename T>
+    static void add(std::span<T> acc, std::span<const T> b) {
+        apply<Op::Add, T>(acc, b, T{});
+    }
+    template <typename T>
+    static void sub(std::span<T> acc, std::span<const T> b) {
+        apply<Op::Sub, T>(acc, b, T{});
+    }
+    template <typename T>
+    static void mul(std::span<T> acc, std::span<const T> b) {
+        apply<Op::Mul, T>(acc, b, T{});
+    }
+    template <typename T>
+    static void mulAdd(std::span<T> acc, T c, std::span<const T> b) {
+        apply<Op::MulAdd, T>(acc, b, c);
+    }
+    template <typename T>
+    static void axpy(std::span<T> acc, T c, std::span<const T> b) {
+        apply<Op::Axpy, T>(acc, b, c);
+    }
+
+    // Runs op with the given kernel, or the scalar loop if this CPU lacks it;
+    // benchmarks use it to compare kernels
+    template <Op op, typename T>
+    static void apply(std::span<T> acc, std::span<const T> b, T c,
+                      SimdLevel level = detectedSimd()) {
+        size_t n = acc.size();
+        size_t i = 0;
+#ifdef TRIBUNE_FIELD_SIMD
+        if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, Fp61>) {
+            // Both are a single uint64_t word; Fp61 is kept reduced
+            static_assert(sizeof(T) == sizeof(uint64_t));
+            auto* a = reinterpret_cast<uint64_t*>(acc.data());
+            auto* bw = reinterpret_cast<const uint64_t*>(b.data());
+            uint64_t cw = word(c);
+            if (level > detectedSimd()) {
+                level = SimdLevel::Scalar;
+            }
+            if (level == SimdLevel::Avx512) {
+                i = loopAvx512<op, std::is_same_v<T, Fp61>>(a, bw, cw, n);
+            } else if (level == SimdLevel::Avx2) {
+                i = loopAvx2<op, std::is_same_v<T, Fp61>>(a, bw, cw, n);
+            }
+        }
+#endif
+        for (; i < n; i++) {
+            acc[i] = scalar<op>(acc[i], b[i], c);
+        }
+    }
+
+private:
+    template <Op op, typename T>
+    static T scalar(T a, T b, T c) {
+        if constexpr (op == Op::Add) return a + b;
+        if constexpr (op == Op::Sub) return a - b;
+        if constexpr (op == Op::Mul) return a * b;
+        if constexpr (op == Op::MulAdd) return a * c + b;
+        if constexpr (op == Op::Axpy) return a + c * b;
+    }
+
+#ifdef TRIBUNE_FIELD_SIMD
+    static uint64_t word(uint64_t x) { return x; }
+    static uint64_t word(Fp61 x) { return x.v; }
+
+    // Lane arithmetic for each ISA, in Z/2^64 (Mersenne = false) or
+    // GF(2^61 - 1) (Mersenne = true). Fp61 lanes stay in [0, P).
+
+    template <bool Mersenne>
+    struct Avx2 {
+        using V = __m256i;
+        static constexpr size_t WIDTH = 4;
+
+        __attribute__((target("avx2"))) static V load(const uint64_t* p) {
+            return _mm256_loadu_si256(reinterpret_cast<const V*>(p));
+        }
+        __attribute__((target("avx2"))) static void store(uint64_t* p, V x) {
+            _mm256_storeu_si256(reinterpret_cast<V*>(p), x);
+        }
+        __attribute__((target("avx2"))) static V broadcast(uint64_t x) {
+            return _mm256_set1_epi64x(static_cast<long long>(x));
+        }
+        // r < 2P to [0, P): r - P is negative exactly when r < P, and both
+        // are below 2^63, so the sign bit picks
+        __attribute__((target("avx2"))) static V condSub(V r) {
+            V t = _mm256_sub_epi64(r, broadcast(Fp61::P));
+            return _mm256_castpd_si256(_mm256_blendv_pd(
+                _mm256_castsi256_pd(t), _mm256_castsi256_pd(r), _mm256_castsi256_pd(t)));
+        }
+        __attribute__((target("avx2"))) static V add(V a, V b) {
+            V r = _mm256_add_epi64(a, b);
+            if constexpr (Mersenne) r = condSub(r);
+            return r;
+        }
+        __attribute__((target("avx2"))) static V sub(V a, V b) {
+            if constexpr (Mersenne) return condSub(_mm256_add_epi64(_mm256_sub_epi64(a, b),
+                                                                    broadcast(Fp61::P)));
+            return _mm256_sub_epi64(a, b);
+        }
+        __attribute__((target("avx2"))) static V mul(V a, V b) {
+            // 32-bit halves: a = ah * 2^32 + al, likewise b
+            V ah = _mm256_srli_epi64(a, 32), bh = _mm256_srli_epi64(b, 32);
+            V ll = _mm256_mul_epu32(a, b);
+            V mid = _mm256_add_epi64(_mm256_mul_epu32(ah, b), _mm256_mul_epu32(a, bh));
+            if constexpr (!Mersenne) {
+                return _mm256_add_epi64(ll, _mm256_slli_epi64(mid, 32));
+            } else {
+                // a, b < 2^61, so ah * bh < 2^58 and mid < 2^62. With 2^61 = 1:
+                // hh * 2^64 = hh * 8 and mid * 2^32 = (mid >> 29) + (mid mod 2^29) * 2^32
+                V p = broadcast(Fp61::P);
+                V hh = _mm256_mul_epu32(ah, bh);
+                V s = _mm256_add_epi64(_mm256_slli_epi64(hh, 3), _mm256_srli_epi64(mid, 29));
+                s = _mm256_add_epi64(
+                    s, _mm256_slli_epi64(_mm256_and_si256(mid, broadcast((1u << 29) - 1)), 32));
+                s = _mm256_add_epi64(s, _mm256_and_si256(ll, p));
+                s = _mm256_add_epi64(s, _mm256_srli_epi64(ll, 61));  // s < 2^63
+                return condSub(_mm256_add_epi64(_mm256_and_si256(s, p), _mm256_srli_epi64(s, 61)));
+            }
+        }
+    };
+
+    template <bool Mersenne>
+    struct Avx512 {
+        using V = __m512i;
+        static constexpr size_t WIDTH = 8;
+
+        __attribute__((target("avx512f"))) static V load(const uint64_t* p) {
+            return _mm512_loadu_si512(p);
+        }
+        __attribute__((target("avx512f"))) static void store(uint64_t* p, V x) {
+            _mm512_storeu_si512(p, x);
+        }
+        __attribute__((target("avx512f"))) static V broadcast(uint64_t x) {
+            return _mm512_set1_epi64(static_cast<long long>(x));
+        }
+        // r < 2P to [0, P)
+        __attribute__((target("avx512f"))) static V condSub(V r) {
+            V p = broadcast(Fp61::P);
+            return _mm512_mask_sub_epi64(r, _mm512_cmpge_epu64_mask(r, p), r, p);
+        }
+        __attribute__((target("avx512f"))) static V add(V a, V b) {
+            V r = _mm512_add_epi64(a, b);
+            if constexpr (Mersenne) r = condSub(r);
+            return r;
+        }
+        __attribute__((target("avx512f"))) static V sub(V a, V b) {
+            if constexpr (Mersenne) return condSub(_mm512_add_epi64(_mm512_sub_epi64(a, b),
+                                                                    broadcast(Fp61::P)));
+            return _mm512_sub_epi64(a, b);
+        }
+        __attribute__((target("avx512f"))) static V mul(V a, V b) {
+            // As in the AVX2 kernel; it also beats the microcoded vpmullq
+            V ah = _mm512_srli_epi64(a, 32), bh = _mm512_srli_epi64(b, 32);
+            V ll = _mm512_mul_epu32(a, b);
+            V mid = _mm512_add_epi64(_mm512_mul_epu32(ah, b), _mm512_mul_epu32(a, bh));
+            if constexpr (!Mersenne) {
+                return _mm512_add_epi64(ll, _mm512_slli_epi64(mid, 32));
+            } else {
+                V p = broadcast(Fp61::P);
+                V hh = _mm512_mul_epu32(ah, bh);
+                V s = _mm512_add_epi64(_mm512_slli_epi64(hh, 3), _mm512_srli_epi64(mid, 29));
+                s = _mm512_add_epi64(
+                    s, _mm512_slli_epi64(_mm512_and_si512(mid, broadcast((1u << 29) - 1)), 32));
+                s = _mm512_add_epi64(s, _mm512_and_si512(ll, p));
+                s = _mm512_add_epi64(s, _mm512_srli_epi64(ll, 61));
+                return condSub(_mm512_add_epi64(_mm512_and_si512(s, p), _mm512_srli_epi64(s, 61)));
+            }
+        }
+    };
+
+    // Whole vectors only; return how many elements they processed
+    template <Op op, bool Mersenne>
+    __attribute__((target("avx2"))) static size_t loopAvx2(uint64_t* acc, const uint64_t* b,
+                                                          uint64_t c, size_t n) {
+        using L = Avx2<Mersenne>;
+        const typename L::V cv = L::broadcast(c);
+        size_t i = 0;
+        for (; i + L::WIDTH <= n; i += L::WIDTH) {
+            typename L::V a = L::load(acc + i), bv = L::load(b + i);
+            if constexpr (op == Op::Add) a = L::add(a, bv);
+            if constexpr (op == Op::Sub) a = L::sub(a, bv);
+            if constexpr (op == Op::Mul) a = L::mul(a, bv);
+            if constexpr (op == Op::MulAdd) a = L::add(L::mul(a, cv), bv);
+            if constexpr (op == Op::Axpy) a = L::add(a, L::mul(cv, bv));
+            L::store(acc + i, a);
+        }
+        return i;
+    }
+
+    template <Op op, bool Mersenne>
+    __attribute__((target("avx512f"))) static size_t loopAvx512(
+        uint64_t* acc, const uint64_t* b, uint64_t c, size_t n) {
+        using L = Avx512<Mersenne>;
+        const typename L::V cv = L::broadcast(c);
+        size_t i = 0;
+        for (; i + L::WIDTH <= n; i += L::WIDTH) {
+            typename L::V a = L::load(acc + i), bv = L::load(b + i);
+            if constexpr (op == Op::Add) a = L::add(a, bv);
+            if constexpr (op == Op::Sub) a = L::sub(a, bv);
+            if constexpr (op == Op::Mul) a = L::mul(a, bv);
+            if constexpr (op == Op::MulAdd) a = L::add(L::mul(a, cv), bv);
+            if constexpr (op == Op::Axpy) a = L::add(a, L::mul(cv, bv));
+            L::store(acc + i, a);
+        }
+        return i;
+    }
+#endif
+};
@@ -0,0 +1,187 @@
+#pragma once
+#include "field.hpp"
+#include "field_ops.hpp"
+#include "mpc_module.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Vectors of field elements on the wire: JSON arrays of uint64_t words,
+// Traits::LIMBS per element with the low word first, or a single number for
+// one single-word element. Client input is always one unsigned integer per
+// element, which decodeInput() reads. Shared by the modules templated on the
+// element type.
+template <typename T>
+struct FieldVector {
+    using Traits = FieldTraits<T>;
+    static constexpr size_t LIMBS = Traits::LIMBS;
+
+    static std::vector<T> decode(const nlohmann::json& j) {
+        std::vector<T> values;
+        Assembler out{values};
+        if (j.is_array()) {
+            values.reserve(j.size() / LIMBS);
+            for (const auto& x : j) {
+                out.push(x.get<uint64_t>());
+            }
+        } else {
+            out.push(j.get<uint64_t>());
+        }
+        out.finish();
+        return values;
+    }
+
+    // Parses a JSON array of unsigned integers without whitespace, which is
+    // what encodeTo() writes, straight from the text; any other input goes
+    // through decode()
+    static std::vector<T> decodeFrom(std::string_view text) {
+        std::vector<T> values;
+        values.reserve(text.size() / (8 * LIMBS));
+        Assembler out{values};
+        if (parseWords(text, [&](uint64_t x) { out.push(x); })) {
+            out.finish();
+            return values;
+        }
+        return decode(nlohmann::json::parse(text));
+    }
+
+    // Client input: a JSON number or array of unsigned integers, one per
+    // element whatever the element's wire width
+    static std::vector<T> decodeInput(const nlohmann::json& j) {
+        std::vector<T> values;
+        if (j.is_array()) {
+            values.reserve(j.size());
+            for (const auto& x : j) {
+                values.push_back(Traits::fromUint64(x.get<uint64_t>()));
+            }
+        } else {
+            values.push_back(Traits::fromUint64(j.get<uint64_t>()));
+        }
+        return values;
+    }
+
+    static std::vector<T> decodeInput(std::string_view text) {
+        if constexpr (LIMBS == 1) {
+            return decodeFrom(text);  // Input and wire formats coincide
+        } else {
+            return decodeInput(nlohmann::json::parse(text));
+        }
+    }
+
+    static nlohmann::json encode(std::span<const T> values) {
+        std::vector<uint64_t> wire(values.size() * LIMBS);
+        for (size_t i = 0; i < values.size(); i++) {
+            Traits::toLimbs(values[i], &wire[i * LIMBS]);
+        }
+        return wire;
+    }
+
+    // Writes the same JSON text as encode(values).dump() into out, reusing its
+    // capacity, without building a JSON array first
+    static void encodeTo(std::span<const T> values, std::string& out) {
+        out.resize(values.size() * LIMBS * 21 + 2);  // 20 digits and a separator each
+        char* p = out.data();
+        char* end = p + out.size();
+        *p++ = '[';
+        uint64_t limbs[LIMBS];
+        for (size_t i = 0; i < values.size(); i++) {
+            Traits::toLimbs(values[i], limbs);
+            for (size_t k = 0; k < LIMBS; k++) {
+                if (i != 0 || k != 0) *p++ = ',';
+                p = std::to_chars(p, end, limbs[k]).ptr;
+            }
+        }
+        *p++ = ']';
+        out.resize(p - out.data());
+    }
+
+    // Element-wise acc += values. Throws std::invalid_argument unless both
+    // have the same length; start a sum from its first operand, as sumOf()
+    // does.
+    static void addInto(std::vector<T>& acc, std::span<const T> values) {
+        if (acc.size() != values.size()) {
+            throw std::invalid_argument("Vector length mismatch: " + std::to_string(acc.size()) +
+                                        " vs " + std::to_string(values.size()));
+        }
+        FieldOps::add(std::span<T>(acc), values);
+    }
+
+    // Sums decode(item) over items. The first operand sets the length and
+    // every other must match it; no items give an empty sum.
+    template <typename Range, typename Decode>
+    static std::vector<T> sumOf(const Range& items, Decode&& decode) {
+        std::vector<T> sum;
+        bool first = true;
+        for (const auto& item : items) {
+            if (first) {
+                sum = decode(item);
+                first = false;
+            } else {
+                addInto(sum, decode(item));
+            }
+        }
+        return sum;
+    }
+
+    static std::vector<T> sumShards(std::span<const ShardView> shards) {
+        return sumOf(shards, [](const ShardView& shard) { return decodeFrom(shard.data); });
+    }
+
+private:
+    // Groups wire words into elements, LIMBS at a time
+    struct Assembler {
+        std::vector<T>& values;
+        uint64_t limbs[LIMBS] = {};
+        size_t filled = 0;
+
+        void push(uint64_t word) {
+            limbs[filled++] = word;
+            if (filled == LIMBS) {
+                values.push_back(Traits::fromLimbs(limbs));
+                filled = 0;
+            }
+        }
+        void finish() const {
+            if (filled != 0) {
+                throw std::invalid_argument("Field vector ends mid-element");
+            }
+        }
+    };
+
+    // Emits each word of a compact JSON array of unsigned integers; false if
+    // the text is not one, leaving the caller to fall back to the JSON parser
+    template <typename Emit>
+    static bool parseWords(std::string_view text, Emit&& emit) {
+        const char* p = text.data();
+        const char* end = p + text.size();
+        if (p == end || *p != '[') {
+            return false;
+        }
+        p++;
+        if (p != end && *p == ']' && p + 1 == end) {
+            return true;
+        }
+        while (p != end && !(*p == '0' && p + 1 != end && std::isdigit(p[1]))) {
+            uint64_t x;
+            auto [next, ec] = std::from_chars(p, end, x);
+            if (ec != std::errc{} || next == end) {
+                return false;
+            }
+            emit(x);
+            p = next + 1;
+            if (*next == ']') {
+                return p == end;
+            }
+            if (*next != ',') {
+                return false;
+            }
+        }
+        return false;
+    }
+};
@@ -0,0 +1,174 @@
+#pragma once
+#include "events/events.hpp"
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define TRIBUNE_FIXED_POINT_AVX2 1
+#endif
+
+// Fixed-point encoding of real values into Z/2^64, for summing floats such as
+// gradients with the integer modules. x is encoded as round(x * 2^frac_bits)
+// in two's complement, and must fit a signed `bits`-bit integer, so up to
+// 2^(64 - bits) encoded values sum without wrapping.
+//
+// Rounding is round-half-to-even via the 1.5 * 2^52 magic-number trick, in
+// both the scalar and the AVX2 kernel. Scaling by a power of two is exact, so
+// every participant encodes bit-identical values whichever kernel its CPU
+// runs.
+//
+// Events opt in with computation_metadata "fixed_point":
+// {"frac_bits": F, "bits": B}; fromEvent() reads it.
+class FixedPointCodec {
+public:
+    // The magic-number trick rounds exactly below 2^51
+    static constexpr int MAX_BITS = 52;
+
+    FixedPointCodec(int frac_bits, int bits)
+        : frac_bits_(frac_bits), bits_(bits),
+          scale_(std::ldexp(1.0, frac_bits)), inv_scale_(std::ldexp(1.0, -frac_bits)),
+          limit_(std::ldexp(1.0, bits - 1)) {
+        if (bits < 2 || bits > MAX_BITS) {
+            throw std::invalid_argument("fixed_point bits must be in [2, " +
+                                        std::to_string(MAX_BITS) + "]");
+        }
+        if (frac_bits < 0 || frac_bits >= bits) {
+            throw std::invalid_argument("fixed_point frac_bits must be in [0, bits)");
+        }
+    }
+
+    static std::optional<FixedPointCodec> fromEvent(const Event& event) {
+        if (!event.computation_metadata.contains("fixed_point")) {
+            return std::nullopt;
+        }
+        const auto& config = event.computation_metadata["fixed_point"];
+        return FixedPointCodec(config.value("frac_bits", 16), config.value("bits", 40));
+    }
+
+    int fracBits() const { return frac_bits_; }
+    int bits() const { return bits_; }
+    // Encoded values that can be summed before the total may wrap
+    uint64_t maxSummands() const { return uint64_t{1} << (64 - bits_); }
+
+    // Encodes values into out, which must be as long. Throws
+    // std::overflow_error for the first value that is not finite or does not
+    // fit in `bits` bits once scaled.
+    void encode(std::span<const double> values, std::span<uint64_t> out) const {
+        encodeAll(values, out);
+    }
+    void encode(std::span<const float> values, std::span<uint64_t> out) const {
+        encodeAll(values, out);
+    }
+
+    // Decodes a sum of `summands` encoded values into out, which must be as
+    // long. Throws std::overflow_error if that many summands may have wrapped.
+    void decode(std::span<const uint64_t> values, std::span<double> out,
+                uint64_t summands = 1) const {
+        if (summands == 0 || summands > maxSummands()) {
+            throw std::overflow_error("Sum of " + std::to_string(summands) + " " +
+                                      std::to_string(bits_) + "-bit fixed point values may wrap");
+        }
+        for (size_t i = 0; i < values.size(); i++) {
+            out[i] = static_cast<double>(static_cast<int64_t>(values[i])) * inv_scale_;
+        }
+    }
+
+    // For modules: encodes a JSON number or array of numbers
+    std::vector<uint64_t> encodeJson(const nlohmann::json& input) const {
+        std::vector<double> values = input.is_array() ? input.get<std::vector<double>>()
+                                                      : std::vector<double>{input.get<double>()};
+        std::vector<uint64_t> encoded(values.size());
+        encode(values, encoded);
+        return encoded;
+    }
+
+    // For modules: decodes an aggregate of `summands` inputs to a JSON array
+    nlohmann::json decodeJson(std::span<const uint64_t> sum, uint64_t summands) const {
+        std::vector<double> values(sum.size());
+        decode(sum, values, summands);
+        return values;
+    }
+
+private:
+    static constexpr double MAGIC = 6755399441055744.0;  // 1.5 * 2^52
+
+    // Scalar kernel; false if x does not fit
+    bool encodeOne(double x, uint64_t& out) const {
+        double t = x * scale_ + MAGIC;
+        if (!(std::fabs(t - MAGIC) < limit_)) {
+            return false;
+        }
+        out = std::bit_cast<uint64_t>(t) - std::bit_cast<uint64_t>(MAGIC);
+        return true;
+    }
+
+    template <typename F>
+    void encodeAll(std::span<const F> values, std::span<uint64_t> out) const {
+        size_t i = 0;
+#ifdef TRIBUNE_FIXED_POINT_AVX2
+        if (hasAvx2()) {
+            i = encodeAvx2(values.data(), out.data(), values.size());
+        }
+#endif
+        // The tail, or the rest from the first vector that did not fit
+        for (; i < values.size(); i++) {
+            if (!encodeOne(static_cast<double>(values[i]), out[i])) {
+                throw std::overflow_error(
+                    "Value " + std::to_string(values[i]) + " at index " + std::to_string(i) +
+                    " does not fit " + std::to_string(bits_) + "-bit fixed point with " +
+                    std::to_string(frac_bits_) + " fractional bits");
+            }
+        }
+    }
+
+#ifdef TRIBUNE_FIXED_POINT_AVX2
+    static bool hasAvx2() {
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+    }
+
+    __attribute__((target("avx2"))) static __m256d load4(const double* p) {
+        return _mm256_loadu_pd(p);
+    }
+    __attribute__((target("avx2"))) static __m256d load4(const float* p) {
+        return _mm256_cvtps_pd(_mm_loadu_ps(p));  // Exact widening
+    }
+
+    // Encodes whole vectors of four; returns how many values it encoded,
+    // stopping before the first vector with a value that does not fit
+    template <typename F>
+    __attribute__((target("avx2"))) size_t encodeAvx2(const F* in, uint64_t* out,
+                                                     size_t n) const {
+        const __m256d scale = _mm256_set1_pd(scale_);
+        const __m256d magic = _mm256_set1_pd(MAGIC);
+        const __m256d limit = _mm256_set1_pd(limit_);
+        const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(INT64_MAX));
+        const __m256i magic_bits = _mm256_castpd_si256(magic);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d t = _mm256_add_pd(_mm256_mul_pd(load4(in + i), scale), magic);
+            __m256d rounded = _mm256_and_pd(_mm256_sub_pd(t, magic), abs_mask);
+            if (_mm256_movemask_pd(_mm256_cmp_pd(rounded, limit, _CMP_LT_OQ)) != 0xF) {
+                break;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                _mm256_sub_epi64(_mm256_castpd_si256(t), magic_bits));
+        }
+        return i;
+    }
+#endif
+
+    int frac_bits_;
+    int bits_;
+    double scale_;
+    double inv_scale_;
+    double limit_;
+};
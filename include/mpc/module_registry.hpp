@@ -0,0 +1,46 @@
+#pragma once
+#include "mpc_module.hpp"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// MPC modules by computation type, shared by client and server. An event
+// resolves its module once, when the node first sees it, and keeps the
+// returned handle: later phases call the module through the handle with no
+// string lookup or registry lock. Re-registering a type affects events seen
+// afterwards; events holding the old handle keep the old module alive.
+//
+// Modules are called concurrently from different events' threads and must
+// be thread-safe.
+class ModuleRegistry {
+public:
+    using Handle = std::shared_ptr<MPCModule>;
+
+    void add(const std::string& type, Handle module) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        modules_[type] = std::move(module);
+    }
+
+    // Registers a concrete module type, e.g. emplace<SecureSum<Fp61>>("sum").
+    // Returns the typed module for callers that want to drive it directly.
+    template <typename Module, typename... Args>
+    std::shared_ptr<Module> emplace(const std::string& type, Args&&... args) {
+        auto module = std::make_shared<Module>(std::forward<Args>(args)...);
+        add(type, module);
+        return module;
+    }
+
+    // Null when no module is registered for type
+    Handle find(const std::string& type) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = modules_.find(type);
+        return it != modules_.end() ? it->second : nullptr;
+    }
+
+private:
+    std::unordered_map<std::string, Handle> modules_;
+    mutable std::shared_mutex mutex_;
+};
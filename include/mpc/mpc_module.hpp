@@ -1,7 +1,11 @@
 #pragma once
 #include "events/events.hpp"
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <nlohmann/json.hpp>
@@ -17,6 +21,15 @@ struct DataShard {
     nlohmann::json metadata;  // Protocol-specific metadata
 };
 
+// Non-owning view of a collected shard; data points into storage the caller
+// keeps alive for the duration of the call
+struct ShardView {
+    size_t participant_index;  // Position of the shard's sender in event->participants
+    std::string_view data;
+
+    std::span<const std::byte> bytes() const { return std::as_bytes(std::span(data)); }
+};
+
 // Result from a single participant's computation
 struct PartialResult {
     std::string participant_id;
@@ -30,13 +43,15 @@ struct FinalResult {
     nlohmann::json value;
     std::string combined_signature;  // Optional threshold/combined signature
     bool verified = false;
+    bool degraded = false;            // Aggregated from a subset of participants after timeout
+    int contributing_participants = 0;
 };
 
 // Metadata about the MPC protocol
 struct ProtocolMetadata {
     std::string protocol_name;
     int min_participants;
-    int threshold;  // For threshold protocols
+    int threshold;  // Partials needed to reconstruct the result (0 = all participants)
     bool requires_trusted_setup;
     nlohmann::json parameters;  // Protocol-specific parameters
 };
@@ -61,6 +76,27 @@ public:
                                              const Event* event,
                                              const std::string& participant_id) = 0;
     
+    // Shard and mask in one pass, writing the shard to transmit to participant
+    // i into out[i]. Input is a byte view and output goes into the caller's
+    // strings, reusing their capacity, so a large payload is not copied
+    // between the two phases. The default adapts shardData() and maskShards().
+    virtual void shardDataInto(std::span<const std::byte> raw_data,
+                               const Event* event,
+                               const std::string& participant_id,
+                               std::vector<std::string>& out) {
+        std::string data(reinterpret_cast<const char*>(raw_data.data()), raw_data.size());
+        std::vector<DataShard> masked = maskShards(shardData(data, event), event, participant_id);
+        out.resize(masked.size());
+        for (size_t i = 0; i < masked.size(); i++) {
+            out[i] = std::move(masked[i].data);
+        }
+    }
+    
+    // Protocols that need no shard exchange (e.g. pairwise masking) return
+    // true. Clients then call shardDataInto() for a single shard, their
+    // masked input, and submit it as their partial without contacting peers.
+    virtual bool submitsDirectly() const { return false; }
+    
     // ===== Computation Phase =====
     
     // Perform partial computation on collected shards from all participants
@@ -69,6 +105,36 @@ public:
     virtual PartialResult computePartial(const Event* event,
                                         const std::vector<DataShard>& collected_shards) = 0;
     
+    // Same computation over views of shards that stay where the caller stored
+    // them, in participant order. The default, for modules that only
+    // implement computePartial(), copies them into DataShards labelled with
+    // their sender; the built-in modules override it to read them in place.
+    virtual PartialResult computePartialViews(const Event* event,
+                                              std::span<const ShardView> shards) {
+        std::vector<DataShard> collected_shards;
+        collected_shards.reserve(shards.size());
+        for (const ShardView& view : shards) {
+            DataShard shard;
+            if (event && view.participant_index < event->participants.size()) {
+                shard.participant_id = event->participants[view.participant_index].client_id;
+            }
+            shard.data.assign(view.data);
+            shard.shard_index = static_cast<int>(view.participant_index);
+            collected_shards.push_back(std::move(shard));
+        }
+        return computePartial(event, collected_shards);
+    }
+    
+    // Writes the serialized partial (what computePartialViews() returns as
+    // value.dump()) into the caller's buffer, reusing its capacity. Modules
+    // that produce the wire format directly override it to skip the
+    // intermediate JSON value.
+    virtual void computePartialInto(const Event* event,
+                                    std::span<const ShardView> shards,
+                                    std::string& out) {
+        out = computePartialViews(event, shards).value.dump();
+    }
+    
     // ===== Aggregation Phase =====
     
     // Aggregate partial results into final result
@@ -76,6 +142,15 @@ public:
     virtual FinalResult aggregate(const std::vector<PartialResult>& partials,
                                 const Event* event) = 0;
     
+    // Combine partials into a single partial that aggregate() accepts in
+    // their place, for intermediate nodes of an aggregation tree. Protocols
+    // that need every partial individually (e.g. threshold reconstruction)
+    // keep the default, and the partials are forwarded as they are.
+    virtual std::optional<PartialResult> combinePartials(const std::vector<PartialResult>& partials,
+                                                         const Event* event) {
+        return std::nullopt;
+    }
+    
     // ===== Verification Phase =====
     
     // Verify the correctness of a final result
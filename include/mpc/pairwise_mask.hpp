@@ -0,0 +1,73 @@
+#pragma once
+#include "mpc_module.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Secure sum by pairwise masking. Every pair of participants (i, j) agrees on
+// a seed via X25519 over their Ed25519 keys, bound to the event ID and the
+// server's signature, and expands it with ChaCha20 into a mask as long as the
+// input. The lower-indexed participant adds the mask and the higher-indexed
+// one subtracts it, so the masks cancel in the sum and the server only learns
+// the total.
+//
+// Each client uploads one masked vector straight to the server, so client
+// bandwidth is O(d) rather than the O(N*d) of a shard exchange. Values are
+// summed in Z/2^64; input is a JSON number or array of unsigned integers.
+//
+// The masks only cancel when every participant submits, so events fail
+// rather than degrade when a participant drops out.
+class PairwiseMaskSum final : public MPCModule {
+public:
+  // private_key is the client's hex Ed25519 secret key, the one it registered
+  // with the server; masking throws if the event lists another key for it.
+  // Servers, which only aggregate, construct it without one.
+  explicit PairwiseMaskSum(const std::string &private_key = "");
+  ~PairwiseMaskSum() override;
+
+  PairwiseMaskSum(const PairwiseMaskSum &) = delete;
+  PairwiseMaskSum &operator=(const PairwiseMaskSum &) = delete;
+
+  ProtocolMetadata getProtocolMetadata() const override;
+  bool submitsDirectly() const override { return true; }
+
+  // The single shard is the client's unmasked input
+  std::vector<DataShard> shardData(const std::string &raw_data,
+                                   const Event *event) override;
+  std::vector<DataShard> maskShards(const std::vector<DataShard> &shards, const Event *event,
+                        const std::string &participant_id) override;
+  void shardDataInto(std::span<const std::byte> raw_data, const Event *event,
+                     const std::string &participant_id,
+                     std::vector<std::string> &out) override;
+
+  PartialResult
+  computePartial(const Event *event,
+                 const std::vector<DataShard> &collected_shards) override;
+  PartialResult computePartialViews(const Event *event,
+                                    std::span<const ShardView> shards) override;
+
+  FinalResult aggregate(const std::vector<PartialResult> &partials,
+                        const Event *event) override;
+  // Masked vectors add like plain ones, so tree nodes can pre-add them
+  std::optional<PartialResult>
+  combinePartials(const std::vector<PartialResult> &partials,
+                  const Event *event) override;
+
+  bool verifyResult(const FinalResult &result, const Event *event) override {
+    return true; // Nothing to check without commitments
+  }
+  bool isProtocolComplete(const std::string &event_id) const override {
+    return false; // Stateless across events
+  }
+  void reset(const std::string &event_id) override {}
+
+private:
+  // Adds the masks of participant_id's pairs to values in place
+  void applyMasks(std::vector<uint64_t> &values, const Event &event,
+                  const std::string &participant_id) const;
+
+  std::array<unsigned char, 32> ed25519_pk_{}; // Checked against the event's roster
+  std::array<unsigned char, 32> x25519_sk_{}; // From the Ed25519 key
+  bool has_key_ = false;
+};
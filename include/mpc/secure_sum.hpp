@@ -1,44 +1,163 @@
 #pragma once
+#include "field.hpp"
+#include "field_ops.hpp"
+#include "field_vector.hpp"
+#include "fixed_point.hpp"
 #include "mpc_module.hpp"
-#include <random>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
 
-class SecureSumModule : public MPCModule {
-private:
+// Additive secret sharing sum over the element type T (uint64_t for the ring
+// Z/2^64, Fp61 for GF(2^61 - 1), Fp128<P> for a prime up to 127 bits). Input
+// is a JSON number or array of unsigned integers; the result is their
+// element-wise sum across clients, in FieldVector's wire format (two words
+// per element, low first, for Fp128). Over Z/2^64, events with "fixed_point"
+// metadata sum reals instead (see FixedPointCodec).
+//
+// Nodes call the module through ModuleRegistry's MPCModule handles, so each
+// phase costs one virtual call; everything below it is a template over T
+// and inlines, and the per-element loops run on FieldOps, which vectorizes
+// them for uint64_t and Fp61.
+template <typename T>
+class SecureSum final : public MPCModule {
 public:
+  using Traits = FieldTraits<T>;
+  using Vector = FieldVector<T>;
+
   ProtocolMetadata getProtocolMetadata() const override {
-    return ProtocolMetadata{};
+    return ProtocolMetadata{std::string("secure_sum_") + Traits::name, 4, 0, false,
+                            nlohmann::json{{"field", Traits::name}}};
   }
 
   std::vector<DataShard> shardData(const std::string &raw_data,
                                    const Event *event) override {
-    return std::vector<DataShard>(); // Dummy implementation
+    std::vector<std::string> encoded;
+    shardInto(nlohmann::json::parse(raw_data), *event, encoded);
+    std::vector<DataShard> shards;
+    shards.reserve(encoded.size());
+    for (size_t i = 0; i < encoded.size(); i++) {
+      shards.push_back(DataShard{event->participants[i].client_id,
+                                 std::move(encoded[i]), static_cast<int>(i),
+                                 nlohmann::json::object()});
+    }
+    return shards;
   }
 
   std::vector<DataShard> maskShards(const std::vector<DataShard> &shards, const Event *event,
                         const std::string &participant_id) override {
-    return std::vector<DataShard>(); // Dummy implementation
+    return shards; // Additive shares are already uniformly random
+  }
+
+  void shardDataInto(std::span<const std::byte> raw_data, const Event *event,
+                     const std::string &participant_id,
+                     std::vector<std::string> &out) override {
+    const char *begin = reinterpret_cast<const char *>(raw_data.data());
+    shardInto(nlohmann::json::parse(begin, begin + raw_data.size()), *event, out);
   }
 
   PartialResult
   computePartial(const Event *event,
                  const std::vector<DataShard> &collected_shards) override {
-    return PartialResult{}; // Dummy implementation
+    return partialOf(Vector::sumOf(collected_shards, [](const DataShard &shard) {
+      return Vector::decodeFrom(shard.data);
+    }));
+  }
+
+  PartialResult computePartialViews(const Event *event,
+                                    std::span<const ShardView> shards) override {
+    return partialOf(Vector::sumShards(shards));
+  }
+
+  void computePartialInto(const Event *event, std::span<const ShardView> shards,
+                          std::string &out) override {
+    Vector::encodeTo(Vector::sumShards(shards), out);
   }
 
   FinalResult aggregate(const std::vector<PartialResult> &partials,
                         const Event *event) override {
-    return FinalResult{}; // Dummy implementation
+    FinalResult result;
+    std::vector<T> sum = sumPartials(partials);
+    result.value = Vector::encode(sum);
+    if constexpr (std::is_same_v<T, uint64_t>) {
+      if (auto codec = event ? fixedPoint(*event) : std::nullopt) {
+        result.value = codec->decodeJson(sum, event->participants.size());
+      }
+    }
+    result.verified = true;
+    return result;
+  }
+
+  // Sums are associative, so aggregation tree nodes can pre-add partials
+  std::optional<PartialResult>
+  combinePartials(const std::vector<PartialResult> &partials,
+                  const Event *event) override {
+    return partialOf(sumPartials(partials));
   }
 
   bool verifyResult(const FinalResult &result, const Event *event) override {
-    return true; // Dummy implementation
+    return true; // Nothing to check without commitments
   }
 
   bool isProtocolComplete(const std::string &event_id) const override {
-    return false; // Dummy implementation
+    return false; // Stateless across events
   }
 
-  void reset(const std::string &event_id) override {
-    // Dummy implementation
+  void reset(const std::string &event_id) override {}
+
+private:
+  static std::optional<FixedPointCodec> fixedPoint(const Event &event) {
+    auto codec = FixedPointCodec::fromEvent(event);
+    if (codec && !std::is_same_v<T, uint64_t>) {
+      throw std::invalid_argument("fixed_point events need SecureSum<uint64_t>");
+    }
+    return codec;
+  }
+
+  // Share i for each element is uniformly random for i > 0; share 0 makes
+  // the shares add up to the input
+  static void shardInto(const nlohmann::json &input, const Event &event,
+                        std::vector<std::string> &out) {
+    size_t count = event.participants.size();
+    std::vector<T> values;
+    if (auto codec = fixedPoint(event)) {
+      if constexpr (std::is_same_v<T, uint64_t>) {
+        values = codec->encodeJson(input);
+      }
+    } else {
+      values = Vector::decodeInput(input);
+    }
+    std::vector<std::vector<T>> shares(count);
+    if (count > 0) {
+      shares[0] = std::move(values);
+    }
+    for (size_t i = 1; i < count; i++) {
+      shares[i].resize(shares[0].size());
+      Traits::randomFill(shares[i]);
+      FieldOps::sub(std::span<T>(shares[0]), std::span<const T>(shares[i]));
+    }
+    out.resize(count);
+    for (size_t i = 0; i < count; i++) {
+      Vector::encodeTo(shares[i], out[i]);
+    }
+  }
+
+  static std::vector<T> sumPartials(const std::vector<PartialResult> &partials) {
+    return Vector::sumOf(partials, [](const PartialResult &partial) {
+      return Vector::decode(partial.value);
+    });
+  }
+
+  static PartialResult partialOf(const std::vector<T> &sum) {
+    PartialResult partial;
+    partial.value = Vector::encode(sum);
+    return partial;
   }
 };
+
+// The original module name, summing over Z/2^64
+using SecureSumModule = SecureSum<uint64_t>;
+// Sums that may exceed 2^61 without wrapping, over GF(2^127 - 1)
+using SecureSum127Module = SecureSum<Fp127>;
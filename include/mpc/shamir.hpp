@@ -0,0 +1,253 @@
+#pragma once
+#include "field.hpp"
+#include "field_ops.hpp"
+#include "field_vector.hpp"
+#include "mpc_module.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Threshold secret sharing sum by Shamir's scheme over the prime field T.
+// Each client hides every input element as the constant term of a random
+// polynomial of degree t - 1 and sends participant j its value at x = j + 1.
+// A participant adds the shares it receives, which gives it a point on the
+// polynomial of the sum, and any t of those points recover the sum at x = 0
+// by Lagrange interpolation. Input is a JSON number or array of unsigned
+// integers, summed mod P; T may be Fp61 or any Fp128<P>.
+//
+// Once shares are exchanged, any t partials reconstruct the result, so up to
+// n - t participants can drop out before submitting and the event still
+// completes (degraded) at the timeout. Fewer than t participants together
+// learn nothing about any input.
+template <typename T>
+class ShamirSum final : public MPCModule {
+  static_assert(!std::is_same_v<T, uint64_t>, "Shamir sharing needs a prime field");
+
+public:
+  using Traits = FieldTraits<T>;
+  using Vector = FieldVector<T>;
+
+  // threshold is t, the partials needed to reconstruct; the server and every
+  // client must use the same one
+  explicit ShamirSum(int threshold) : threshold_(threshold) {
+    if (threshold < 1) {
+      throw std::invalid_argument("Shamir threshold must be at least 1");
+    }
+  }
+
+  ProtocolMetadata getProtocolMetadata() const override {
+    return ProtocolMetadata{std::string("shamir_sum_") + Traits::name, threshold_,
+                            threshold_, false,
+                            nlohmann::json{{"field", Traits::name},
+                                           {"threshold", threshold_}}};
+  }
+
+  std::vector<DataShard> shardData(const std::string &raw_data,
+                                   const Event *event) override {
+    std::vector<std::string> encoded;
+    shareInto(raw_data, *event, encoded);
+    std::vector<DataShard> shards;
+    shards.reserve(encoded.size());
+    for (size_t i = 0; i < encoded.size(); i++) {
+      shards.push_back(DataShard{event->participants[i].client_id,
+                                 std::move(encoded[i]), static_cast<int>(i),
+                                 nlohmann::json::object()});
+    }
+    return shards;
+  }
+
+  std::vector<DataShard> maskShards(const std::vector<DataShard> &shards, const Event *event,
+                        const std::string &participant_id) override {
+    return shards; // Fewer than t shares are already uniformly random
+  }
+
+  void shardDataInto(std::span<const std::byte> raw_data, const Event *event,
+                     const std::string &participant_id,
+                     std::vector<std::string> &out) override {
+    const char *begin = reinterpret_cast<const char *>(raw_data.data());
+    shareInto(std::string_view(begin, raw_data.size()), *event, out);
+  }
+
+  // Shares at the same x add to a share of the sum
+  PartialResult
+  computePartial(const Event *event,
+                 const std::vector<DataShard> &collected_shards) override {
+    PartialResult partial;
+    partial.value = Vector::encode(Vector::sumOf(
+        collected_shards, [](const DataShard &shard) { return Vector::decodeFrom(shard.data); }));
+    return partial;
+  }
+
+  PartialResult computePartialViews(const Event *event,
+                                    std::span<const ShardView> shards) override {
+    PartialResult partial;
+    partial.value = Vector::encode(Vector::sumShards(shards));
+    return partial;
+  }
+
+  void computePartialInto(const Event *event, std::span<const ShardView> shards,
+                          std::string &out) override {
+    Vector::encodeTo(Vector::sumShards(shards), out);
+  }
+
+  // Interpolates at 0 from the t lowest-indexed participants that submitted.
+  // combinePartials() keeps the default, so aggregation trees forward every
+  // partial with its participant ID.
+  FinalResult aggregate(const std::vector<PartialResult> &partials,
+                        const Event *event) override {
+    if (!event) {
+      throw std::invalid_argument("Shamir reconstruction needs the event");
+    }
+    std::unordered_map<std::string, size_t> index_of;
+    for (size_t i = 0; i < event->participants.size(); i++) {
+      index_of.emplace(event->participants[i].client_id, i);
+    }
+    std::vector<std::pair<size_t, const PartialResult *>> points;
+    for (const auto &partial : partials) {
+      auto it = index_of.find(partial.participant_id);
+      if (it != index_of.end()) {
+        points.emplace_back(it->second, &partial);
+      }
+    }
+    std::sort(points.begin(), points.end(),
+              [](const auto &a, const auto &b) { return a.first < b.first; });
+    points.erase(std::unique(points.begin(), points.end(),
+                             [](const auto &a, const auto &b) { return a.first == b.first; }),
+                 points.end());
+
+    size_t t = static_cast<size_t>(threshold_);
+    if (points.size() < t) {
+      throw std::runtime_error("Shamir reconstruction needs " + std::to_string(t) +
+                               " partials, got " + std::to_string(points.size()));
+    }
+    points.resize(t);
+
+    std::vector<uint64_t> xs(t);
+    for (size_t i = 0; i < t; i++) {
+      xs[i] = points[i].first + 1;
+    }
+    std::shared_ptr<const std::vector<T>> lambdas = lagrangeAtZero(xs);
+
+    std::vector<T> sum;
+    for (size_t i = 0; i < t; i++) {
+      std::vector<T> y = Vector::decode(points[i].second->value);
+      if (i == 0) {
+        sum.resize(y.size());
+      } else if (y.size() != sum.size()) {
+        throw std::runtime_error("Shamir partials differ in length");
+      }
+      FieldOps::axpy(std::span<T>(sum), (*lambdas)[i], std::span<const T>(y));
+    }
+
+    FinalResult result;
+    result.value = Vector::encode(sum);
+    result.verified = true;
+    return result;
+  }
+
+  bool verifyResult(const FinalResult &result, const Event *event) override {
+    return true; // Nothing to check without commitments
+  }
+
+  bool isProtocolComplete(const std::string &event_id) const override {
+    return false; // Stateless across events
+  }
+
+  void reset(const std::string &event_id) override {}
+
+private:
+  // Elements per block of share generation, so the t coefficient blocks stay
+  // in cache while every participant's shares are evaluated from them
+  static constexpr size_t BLOCK = 2048;
+  // Participant sets whose Lagrange coefficients are kept
+  static constexpr size_t MAX_CACHED_SETS = 256;
+
+  // Coefficient 0 of each polynomial is the secret and the rest are random.
+  // Participant j's shares are evaluated at x = j + 1 by Horner's rule, one
+  // multiply-add per coefficient across a whole block of secrets at once.
+  void shareInto(std::string_view input, const Event &event,
+                 std::vector<std::string> &out) const {
+    size_t n = event.participants.size();
+    size_t t = static_cast<size_t>(threshold_);
+    if (n < t) {
+      throw std::invalid_argument("Shamir threshold " + std::to_string(t) +
+                                  " exceeds the event's " + std::to_string(n) +
+                                  " participants");
+    }
+
+    std::vector<std::vector<T>> coeffs(t);
+    coeffs[0] = Vector::decodeInput(input);
+    size_t d = coeffs[0].size();
+    for (size_t k = 1; k < t; k++) {
+      coeffs[k].resize(d);
+      Traits::randomFill(coeffs[k]);
+    }
+
+    std::vector<std::vector<T>> shares(n, std::vector<T>(d));
+    for (size_t begin = 0; begin < d; begin += BLOCK) {
+      size_t len = std::min(BLOCK, d - begin);
+      for (size_t j = 0; j < n; j++) {
+        std::span<T> acc = std::span<T>(shares[j]).subspan(begin, len);
+        std::copy_n(coeffs[t - 1].begin() + begin, len, acc.begin());
+        T x = Traits::fromUint64(j + 1);
+        for (size_t k = t - 1; k-- > 0;) {
+          FieldOps::mulAdd(acc, x, std::span<const T>(coeffs[k]).subspan(begin, len));
+        }
+      }
+    }
+
+    out.resize(n);
+    for (size_t j = 0; j < n; j++) {
+      Vector::encodeTo(shares[j], out[j]);
+    }
+  }
+
+  // lambda_i = prod over j != i of x_j / (x_j - x_i), so that the sum of
+  // lambda_i * f(x_i) is f(0). Computed once per participant set.
+  std::shared_ptr<const std::vector<T>> lagrangeAtZero(const std::vector<uint64_t> &xs) {
+    {
+      std::lock_guard<std::mutex> lock(lagrange_mutex_);
+      auto it = lagrange_cache_.find(xs);
+      if (it != lagrange_cache_.end()) {
+        return it->second;
+      }
+    }
+
+    auto lambdas = std::make_shared<std::vector<T>>(xs.size());
+    for (size_t i = 0; i < xs.size(); i++) {
+      T num = Traits::fromUint64(1), den = Traits::fromUint64(1);
+      T xi = Traits::fromUint64(xs[i]);
+      for (size_t j = 0; j < xs.size(); j++) {
+        if (j != i) {
+          T xj = Traits::fromUint64(xs[j]);
+          num *= xj;
+          den *= xj - xi;
+        }
+      }
+      (*lambdas)[i] = num * den.inverse();
+    }
+
+    std::lock_guard<std::mutex> lock(lagrange_mutex_);
+    if (lagrange_cache_.size() >= MAX_CACHED_SETS) {
+      lagrange_cache_.clear();
+    }
+    lagrange_cache_.emplace(xs, lambdas);
+    return lambdas;
+  }
+
+  const int threshold_;
+
+  std::mutex lagrange_mutex_;
+  // Keyed by the sorted x coordinates of the participants reconstructed from
+  std::map<std::vector<uint64_t>, std::shared_ptr<const std::vector<T>>> lagrange_cache_;
+};
+
+// Shamir sharing over GF(2^61 - 1)
+using ShamirSumModule = ShamirSum<Fp61>;
@@ -25,8 +25,18 @@ public:
   std::string client_id_;
   std::string ed25519_pub_;
   std::chrono::steady_clock::time_point last_ping_time_;
+
+  // Participation history, used for latency/reliability-weighted selection
+  double avg_response_ms_ = 0.0; // EWMA of announce-to-submit latency
+  int events_assigned_ = 0;
+  int events_completed_ = 0;
+
+  size_t roster_slot_ = 0; // Index in Roster's dense slot array
   
   bool isAlive(int timeout_seconds) const;
   void updatePingTime();
+  void recordResponseLatency(double latency_ms);
+  void recordParticipation(bool responded);
+  double selectionWeight() const;
 };
 
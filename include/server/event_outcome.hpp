@@ -0,0 +1,140 @@
+#pragma once
+#include "mpc/mpc_module.hpp"
+#include <atomic>
+#include <coroutine>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+// How an announced event ended
+enum class EventStatus {
+  Completed, // Aggregated; FinalResult::degraded is set if some participants were missing
+  TimedOut,  // Too few contributions, or clients to announce to, before event_timeout_boundary
+  Failed,    // No module for the computation type, or aggregation threw
+  Cancelled  // The server stopped first
+};
+
+inline const char *toString(EventStatus status) {
+  switch (status) {
+  case EventStatus::Completed:
+    return "completed";
+  case EventStatus::TimedOut:
+    return "timed out";
+  case EventStatus::Failed:
+    return "failed";
+  case EventStatus::Cancelled:
+    return "cancelled";
+  }
+  return "unknown";
+}
+
+struct EventOutcome {
+  std::string event_id;
+  EventStatus status = EventStatus::Failed;
+  std::optional<FinalResult> result; // Set when status is Completed
+  std::string error;                 // Why the event did not complete
+
+  bool ok() const { return status == EventStatus::Completed; }
+};
+
+// Thrown from futures and co_await when an event does not complete
+class EventError : public std::runtime_error {
+public:
+  explicit EventError(const EventOutcome &outcome)
+      : std::runtime_error("Event " + outcome.event_id + " " +
+                           toString(outcome.status) +
+                           (outcome.error.empty() ? "" : ": " + outcome.error)),
+        event_id_(outcome.event_id), status_(outcome.status) {}
+
+  const std::string &eventId() const { return event_id_; }
+  EventStatus status() const { return status_; }
+
+private:
+  std::string event_id_;
+  EventStatus status_;
+};
+
+// Runs on the thread that settles the event (a submit handler, the deadline
+// checker or stop()), so it should hand heavy work off rather than block
+using EventCallback = std::function<void(const EventOutcome &)>;
+
+// Delivers an event's outcome to its callback exactly once, however many
+// threads race to settle it
+class EventCompletion {
+public:
+  explicit EventCompletion(EventCallback callback)
+      : callback_(std::move(callback)) {}
+
+  void complete(const EventOutcome &outcome) {
+    if (done_.exchange(true)) {
+      return;
+    }
+    if (callback_) {
+      callback_(outcome);
+    }
+  }
+
+private:
+  EventCallback callback_;
+  std::atomic<bool> done_{false};
+};
+
+// Callback that fulfills a future with the result, or with an EventError
+inline std::pair<EventCallback, std::future<FinalResult>> futureCallback() {
+  auto promise = std::make_shared<std::promise<FinalResult>>();
+  auto future = promise->get_future();
+  EventCallback callback = [promise](const EventOutcome &outcome) {
+    if (outcome.ok()) {
+      promise->set_value(*outcome.result);
+    } else {
+      promise->set_exception(std::make_exception_ptr(EventError(outcome)));
+    }
+  };
+  return {std::move(callback), std::move(future)};
+}
+
+// co_await-able event result. Awaiting starts the event and suspends the
+// coroutine without blocking a thread; it resumes on the thread that settles
+// the event, returning the FinalResult or throwing EventError.
+class EventAwaiter {
+public:
+  using Starter = std::function<void(EventCallback)>;
+
+  explicit EventAwaiter(Starter start) : start_(std::move(start)) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle) {
+    state_->handle = handle;
+    start_([state = state_](const EventOutcome &outcome) {
+      state->outcome = outcome;
+      // Whichever of this and await_suspend finishes second resumes
+      if (state->arrived.exchange(true)) {
+        state->handle.resume();
+      }
+    });
+    // Settled synchronously: keep running instead of suspending
+    return !state_->arrived.exchange(true);
+  }
+
+  FinalResult await_resume() {
+    if (!state_->outcome.ok()) {
+      throw EventError(state_->outcome);
+    }
+    return std::move(*state_->outcome.result);
+  }
+
+private:
+  struct State {
+    std::coroutine_handle<> handle;
+    EventOutcome outcome;
+    std::atomic<bool> arrived{false};
+  };
+
+  Starter start_;
+  std::shared_ptr<State> state_ = std::make_shared<State>();
+};
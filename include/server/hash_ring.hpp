@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Consistent hash ring over shard addresses ("host:port"). Each shard is
+// placed at several virtual points so keys spread evenly, and adding or
+// removing a shard only moves the keys next to its points. The hash is
+// stable across processes and builds, so every shard agrees on ownership.
+class HashRing {
+public:
+  explicit HashRing(size_t virtual_nodes = 128) : virtual_nodes_(virtual_nodes) {}
+
+  void addNode(const std::string &node);
+  bool contains(const std::string &node) const;
+  bool empty() const { return points_.empty(); }
+  const std::vector<std::string> &nodes() const { return nodes_; }
+
+  // Shard owning key: the first point clockwise from the key's hash
+  const std::string &ownerOf(std::string_view key) const;
+
+  static uint64_t hash(std::string_view data);
+
+private:
+  size_t virtual_nodes_;
+  std::vector<std::string> nodes_;
+  std::vector<std::pair<uint64_t, size_t>> points_; // (hash, index in nodes_), sorted
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include "client_state.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Connected clients, keyed by client ID, plus a dense slot array over the same
+// entries so participants can be sampled by index without walking or copying
+// the whole map. Not thread-safe; guarded by the server's roster mutex.
+class Roster {
+public:
+  using Map = std::unordered_map<std::string, ClientState>;
+
+  // Insert or replace a client, keeping its slot if it reconnects
+  ClientState &upsert(ClientState state);
+  bool erase(const std::string &client_id);
+
+  Map::iterator find(const std::string &client_id) { return clients_.find(client_id); }
+  Map::const_iterator find(const std::string &client_id) const { return clients_.find(client_id); }
+  Map::iterator begin() { return clients_.begin(); }
+  Map::iterator end() { return clients_.end(); }
+  Map::const_iterator begin() const { return clients_.begin(); }
+  Map::const_iterator end() const { return clients_.end(); }
+  size_t size() const { return slots_.size(); }
+
+  const ClientState &at(size_t slot) const { return *slots_[slot]; }
+
+  // k distinct slots chosen uniformly at random in random order.
+  // Floyd's algorithm followed by a shuffle: O(k) expected, independent of size()
+  template <typename Rng>
+  std::vector<size_t> sampleSlots(size_t k, Rng &rng) const {
+    size_t n = slots_.size();
+    k = std::min(k, n);
+
+    std::vector<size_t> chosen;
+    chosen.reserve(k);
+    std::unordered_set<size_t> taken;
+    taken.reserve(k);
+    for (size_t j = n - k; j < n; j++) {
+      size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+      size_t pick = taken.count(t) ? j : t;
+      taken.insert(pick);
+      chosen.push_back(pick);
+    }
+    std::shuffle(chosen.begin(), chosen.end(), rng);
+    return chosen;
+  }
+
+private:
+  Map clients_;
+  // Node-based map entries never move, so these stay valid until erased
+  std::vector<ClientState *> slots_;
+};
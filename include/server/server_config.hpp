@@ -2,6 +2,7 @@
 #include <string>
 #include <fstream>
 #include <stdexcept>
+#include <vector>
 #include <nlohmann/json.hpp>
 
 struct ServerConfig {
@@ -9,18 +10,51 @@ struct ServerConfig {
   std::string host;
   int port;
 
+  // HTTP worker pool and request limits
+  int http_worker_threads;             // 0 = one per hardware thread (min 8)
+  int http_max_queued_requests;        // Connections waiting for a worker before shedding with 503 (0 = never shed)
+  int http_retry_after_seconds;        // Retry-After sent with 503 responses
+  int http_payload_max_bytes;          // Larger request bodies are rejected with 413
+  int http_keep_alive_max_count;       // Requests served per connection before it is closed
+  int http_keep_alive_timeout_seconds;
+  int http_read_timeout_seconds;
+  int http_write_timeout_seconds;
+
   // Participant selection
   int min_participants;
   int max_participants;
+  int speculative_extra_participants; // Extra participants for threshold modules; finalize at threshold
+  bool weighted_selection;            // Prefer clients with low latency and high completion rate
 
+  // Hierarchical aggregation (participants combine partials up an F-ary tree)
+  int aggregation_tree_fan_in;             // 0 = every participant submits to the server
+  int aggregation_tree_min_participants;   // Smaller events skip the tree
+  int aggregation_tree_level_timeout_ms;   // How long each tree level waits for its children
+  
+  // Event scheduler
+  int max_events_in_flight;               // Scheduled events active at once
+  bool scheduler_disjoint_participants;   // Prefer clients not in an active event
+  std::string scheduled_computation_type; // Announced every event_announce_interval_seconds; empty = off
+  
   // Event timing
   int event_announce_interval_seconds;
   int event_timeout_boundary;
+  bool aggregate_partial_on_timeout; // Aggregate timed-out events that met the module threshold
   
   // Heartbeat settings
   int ping_interval_seconds;
   int client_timeout_seconds;
   
+  // Sharded coordinator mode (disabled when shard_peers is empty)
+  std::vector<std::string> shard_peers; // "host:port" of every shard, this one included
+  int shard_virtual_nodes;              // Points per shard on the consistent hash ring
+  
+  // Persistence (disabled when state_dir is empty)
+  std::string state_dir;          // Write-ahead log and snapshots
+  std::string identity_file;      // Ed25519 keypair; defaults to <state_dir>/identity.json
+  int snapshot_interval_seconds;  // How often the log is compacted into a snapshot
+  bool wal_fsync;                 // fsync each group commit
+  
   // TLS settings
   bool use_tls;
   std::string cert_file;
@@ -30,12 +64,35 @@ struct ServerConfig {
     // Set defaults
     host = "localhost";
     port = 8080;
+    http_worker_threads = 0;
+    http_max_queued_requests = 256;
+    http_retry_after_seconds = 1;
+    http_payload_max_bytes = 8 * 1024 * 1024;
+    http_keep_alive_max_count = 5;
+    http_keep_alive_timeout_seconds = 5;
+    http_read_timeout_seconds = 5;
+    http_write_timeout_seconds = 5;
     min_participants = 3;
     max_participants = 10;
+    speculative_extra_participants = 0;
+    weighted_selection = false;
+    aggregation_tree_fan_in = 0;
+    aggregation_tree_min_participants = 64;
+    aggregation_tree_level_timeout_ms = 5000;
+    max_events_in_flight = 4;
+    scheduler_disjoint_participants = true;
+    scheduled_computation_type = "";
     event_announce_interval_seconds = 40;
     event_timeout_boundary = 120;
+    aggregate_partial_on_timeout = true;
     ping_interval_seconds = 10;
     client_timeout_seconds = 30;
+    shard_peers = {};
+    shard_virtual_nodes = 128;
+    state_dir = "";
+    identity_file = "";
+    snapshot_interval_seconds = 60;
+    wal_fsync = true;
     use_tls = false;
     cert_file = "";
     private_key_file = "";
@@ -49,12 +106,35 @@ struct ServerConfig {
         
         if (config.contains("host")) host = config["host"];
         if (config.contains("port")) port = config["port"];
+        if (config.contains("http_worker_threads")) http_worker_threads = config["http_worker_threads"];
+        if (config.contains("http_max_queued_requests")) http_max_queued_requests = config["http_max_queued_requests"];
+        if (config.contains("http_retry_after_seconds")) http_retry_after_seconds = config["http_retry_after_seconds"];
+        if (config.contains("http_payload_max_bytes")) http_payload_max_bytes = config["http_payload_max_bytes"];
+        if (config.contains("http_keep_alive_max_count")) http_keep_alive_max_count = config["http_keep_alive_max_count"];
+        if (config.contains("http_keep_alive_timeout_seconds")) http_keep_alive_timeout_seconds = config["http_keep_alive_timeout_seconds"];
+        if (config.contains("http_read_timeout_seconds")) http_read_timeout_seconds = config["http_read_timeout_seconds"];
+        if (config.contains("http_write_timeout_seconds")) http_write_timeout_seconds = config["http_write_timeout_seconds"];
         if (config.contains("min_participants")) min_participants = config["min_participants"];
         if (config.contains("max_participants")) max_participants = config["max_participants"];
+        if (config.contains("speculative_extra_participants")) speculative_extra_participants = config["speculative_extra_participants"];
+        if (config.contains("weighted_selection")) weighted_selection = config["weighted_selection"];
+        if (config.contains("aggregation_tree_fan_in")) aggregation_tree_fan_in = config["aggregation_tree_fan_in"];
+        if (config.contains("aggregation_tree_min_participants")) aggregation_tree_min_participants = config["aggregation_tree_min_participants"];
+        if (config.contains("aggregation_tree_level_timeout_ms")) aggregation_tree_level_timeout_ms = config["aggregation_tree_level_timeout_ms"];
+        if (config.contains("max_events_in_flight")) max_events_in_flight = config["max_events_in_flight"];
+        if (config.contains("scheduler_disjoint_participants")) scheduler_disjoint_participants = config["scheduler_disjoint_participants"];
+        if (config.contains("scheduled_computation_type")) scheduled_computation_type = config["scheduled_computation_type"];
         if (config.contains("event_announce_interval_seconds")) event_announce_interval_seconds = config["event_announce_interval_seconds"];
         if (config.contains("event_timeout_boundary")) event_timeout_boundary = config["event_timeout_boundary"];
+        if (config.contains("aggregate_partial_on_timeout")) aggregate_partial_on_timeout = config["aggregate_partial_on_timeout"];
         if (config.contains("ping_interval_seconds")) ping_interval_seconds = config["ping_interval_seconds"];
         if (config.contains("client_timeout_seconds")) client_timeout_seconds = config["client_timeout_seconds"];
+        if (config.contains("shard_peers")) shard_peers = config["shard_peers"].get<std::vector<std::string>>();
+        if (config.contains("shard_virtual_nodes")) shard_virtual_nodes = config["shard_virtual_nodes"];
+        if (config.contains("state_dir")) state_dir = config["state_dir"];
+        if (config.contains("identity_file")) identity_file = config["identity_file"];
+        if (config.contains("snapshot_interval_seconds")) snapshot_interval_seconds = config["snapshot_interval_seconds"];
+        if (config.contains("wal_fsync")) wal_fsync = config["wal_fsync"];
         if (config.contains("use_tls")) use_tls = config["use_tls"];
         if (config.contains("cert_file")) cert_file = config["cert_file"];
         if (config.contains("private_key_file")) private_key_file = config["private_key_file"];
@@ -74,6 +154,30 @@ private:
       throw std::invalid_argument("Invalid port: " + std::to_string(port) + ". Must be 1-65535");
     }
     
+    if (http_worker_threads < 0) {
+      throw std::invalid_argument("Invalid http_worker_threads: " + std::to_string(http_worker_threads) + ". Must be >= 0 (0 = auto)");
+    }
+    
+    if (http_max_queued_requests < 0) {
+      throw std::invalid_argument("Invalid http_max_queued_requests: " + std::to_string(http_max_queued_requests) + ". Must be >= 0 (0 = unbounded)");
+    }
+    
+    if (http_retry_after_seconds < 1) {
+      throw std::invalid_argument("Invalid http_retry_after_seconds: " + std::to_string(http_retry_after_seconds) + ". Must be >= 1");
+    }
+    
+    if (http_payload_max_bytes < 1) {
+      throw std::invalid_argument("Invalid http_payload_max_bytes: " + std::to_string(http_payload_max_bytes) + ". Must be >= 1");
+    }
+    
+    if (http_keep_alive_max_count < 1) {
+      throw std::invalid_argument("Invalid http_keep_alive_max_count: " + std::to_string(http_keep_alive_max_count) + ". Must be >= 1");
+    }
+    
+    if (http_keep_alive_timeout_seconds < 1 || http_read_timeout_seconds < 1 || http_write_timeout_seconds < 1) {
+      throw std::invalid_argument("HTTP keep-alive, read and write timeouts must be >= 1 second");
+    }
+    
     if (min_participants < 1) {
       throw std::invalid_argument("Invalid min_participants: " + std::to_string(min_participants) + ". Must be >= 1");
     }
@@ -82,6 +186,22 @@ private:
       throw std::invalid_argument("Invalid max_participants: " + std::to_string(max_participants) + ". Must be >= min_participants (" + std::to_string(min_participants) + ")");
     }
     
+    if (speculative_extra_participants < 0) {
+      throw std::invalid_argument("Invalid speculative_extra_participants: " + std::to_string(speculative_extra_participants) + ". Must be >= 0");
+    }
+    
+    if (aggregation_tree_fan_in != 0 && aggregation_tree_fan_in < 2) {
+      throw std::invalid_argument("Invalid aggregation_tree_fan_in: " + std::to_string(aggregation_tree_fan_in) + ". Must be 0 (disabled) or >= 2");
+    }
+    
+    if (aggregation_tree_level_timeout_ms < 1) {
+      throw std::invalid_argument("Invalid aggregation_tree_level_timeout_ms: " + std::to_string(aggregation_tree_level_timeout_ms) + ". Must be >= 1");
+    }
+    
+    if (max_events_in_flight < 1) {
+      throw std::invalid_argument("Invalid max_events_in_flight: " + std::to_string(max_events_in_flight) + ". Must be >= 1");
+    }
+    
     if (event_announce_interval_seconds < 1) {
       throw std::invalid_argument("Invalid event_announce_interval_seconds: " + std::to_string(event_announce_interval_seconds) + ". Must be >= 1");
     }
@@ -102,6 +222,24 @@ private:
       throw std::invalid_argument("Host cannot be empty");
     }
     
+    if (shard_virtual_nodes < 1) {
+      throw std::invalid_argument("Invalid shard_virtual_nodes: " + std::to_string(shard_virtual_nodes) + ". Must be >= 1");
+    }
+    
+    for (const auto& peer : shard_peers) {
+      if (peer.find(':') == std::string::npos) {
+        throw std::invalid_argument("Invalid shard peer: " + peer + ". Must be host:port");
+      }
+    }
+    
+    if (snapshot_interval_seconds < 1) {
+      throw std::invalid_argument("Invalid snapshot_interval_seconds: " + std::to_string(snapshot_interval_seconds) + ". Must be >= 1");
+    }
+    
+    if (identity_file.empty() && !state_dir.empty()) {
+      identity_file = state_dir + "/identity.json";
+    }
+    
     if (use_tls) {
       if (cert_file.empty() || private_key_file.empty()) {
         throw std::invalid_argument("TLS enabled but cert_file or private_key_file not provided");
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Durable server state: an append-only JSON-lines write-ahead log plus
+// periodic compacted snapshots, both under one directory.
+//
+// Every record gets a sequence number. Records are handed to a writer thread
+// that writes (and optionally fsyncs) whatever accumulated since its last
+// write in one go (group commit), so concurrent callers share a single sync.
+// A snapshot at sequence S covers every record <= S; writing one drops those
+// records from the log.
+class StateStore {
+public:
+  struct Recovered {
+    nlohmann::json snapshot; // null when there is no snapshot yet
+    std::vector<nlohmann::json> records; // Log records after the snapshot, in order
+  };
+
+  StateStore(const std::string &directory, bool fsync_writes);
+  ~StateStore();
+
+  StateStore(const StateStore &) = delete;
+  StateStore &operator=(const StateStore &) = delete;
+
+  // Reads the snapshot and log, dropping a torn trailing record.
+  // Call once, before open().
+  Recovered load();
+  // Starts the writer; appends continue after the last recovered record
+  void open();
+  // Flushes everything appended so far and stops the writer
+  void close();
+
+  // Assigns the next sequence number and queues the record. Callers hold the
+  // lock of the state the record describes, so log order matches state order.
+  uint64_t append(nlohmann::json record);
+  // Blocks until the record with this sequence number is on disk
+  void waitDurable(uint64_t seq);
+  uint64_t lastSeq() const { return next_seq_ - 1; }
+
+  // Atomically replaces the snapshot with state as of seq, then drops the
+  // log records it covers
+  void writeSnapshot(const nlohmann::json &state, uint64_t seq);
+
+  // Loads the Ed25519 keypair (public, private) from path, or generates one
+  // and writes it there with owner-only permissions
+  static std::pair<std::string, std::string>
+  loadOrCreateIdentity(const std::string &path);
+
+private:
+  void writerLoop();
+  void writeAll(const std::string &data);
+  void openLog();
+
+  std::string directory_;
+  std::string log_path_;
+  std::string snapshot_path_;
+  bool fsync_writes_;
+
+  int log_fd_ = -1;
+  std::mutex file_mutex_; // Serializes log writes against compaction
+
+  std::vector<nlohmann::json> pending_;
+  std::atomic<uint64_t> next_seq_{1};
+  uint64_t durable_seq_ = 0;
+  bool stopping_ = false;
+  bool writer_running_ = false; // Appends are not waited on without a writer
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::condition_variable durable_cv_;
+  std::thread writer_thread_;
+};
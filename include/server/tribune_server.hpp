@@ -1,22 +1,31 @@
 #pragma once
 #include "client_state.hpp"
+#include "event_outcome.hpp"
+#include "hash_ring.hpp"
+#include "roster.hpp"
 #include "events/events.hpp"
-#include "mpc/mpc_module.hpp"
+#include "mpc/module_registry.hpp"
 #include "server_config.hpp"
+#include "state_store.hpp"
+#include "utils/bounded_task_queue.hpp"
 #include "utils/connection_pool.hpp"
+#include "utils/deadline_queue.hpp"
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
 #include <httplib.h>
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <queue>
 #include <random>
 #include <shared_mutex>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 class TribuneServer {
 public:
@@ -26,22 +35,65 @@ public:
 
   void start();
   void stop();
-  void announceEvent(const Event &event, std::string *result = nullptr);
+  // Announces an event created with createEvent(). The future holds the
+  // aggregated result, or an EventError if the event times out below the
+  // module threshold, fails to aggregate or the server stops first.
+  std::future<FinalResult> announceEvent(const Event &event);
+  // Same, delivering the outcome to on_complete exactly once
+  void announceEvent(const Event &event, EventCallback on_complete);
 
   // Event creation with participant selection
   std::optional<Event> createEvent(EventType type, const std::string &event_id,
                                    const std::string &computation_type = "sum");
 
+  // Queues an event for the scheduler, which creates and announces it once
+  // fewer than max_events_in_flight events are active and enough clients
+  // are connected. If there are still too few clients event_timeout_boundary
+  // after submission, the event times out. Requires start().
+  std::future<FinalResult>
+  submitEvent(EventType type, const std::string &event_id,
+              const std::string &computation_type = "sum",
+              nlohmann::json computation_metadata = nlohmann::json::object());
+  void submitEvent(EventType type, const std::string &event_id,
+                   const std::string &computation_type,
+                   nlohmann::json computation_metadata,
+                   EventCallback on_complete);
+  // Coroutine form: FinalResult r = co_await server.awaitEvent(...). The event
+  // is queued when awaited; no thread waits on it meanwhile.
+  EventAwaiter
+  awaitEvent(EventType type, const std::string &event_id,
+             const std::string &computation_type = "sum",
+             nlohmann::json computation_metadata = nlohmann::json::object());
+
   // MPC module management
   void registerModule(const std::string &type,
                      std::unique_ptr<MPCModule> module);
+  // Registers a concrete module type, e.g.
+  // registerModule<SecureSum<Fp61>>("secure_sum_fp61")
+  template <typename Module, typename... Args>
+  std::shared_ptr<Module> registerModule(const std::string &type, Args &&...args) {
+    return modules_.emplace<Module>(type, std::forward<Args>(args)...);
+  }
 
   // Server identity
   const std::string &getServerPublicKey() const { return server_public_key_; }
 
 private:
-  // Participant selection (internal)
-  std::vector<ClientInfo> selectParticipants();
+  // Participant selection (internal). Clients in avoid are skipped when
+  // enough others are connected.
+  std::vector<ClientInfo>
+  selectParticipants(int extra_participants = 0,
+                     const std::unordered_set<std::string> &avoid = {});
+  // Uniform sample of up to count local clients, plus the local roster size
+  std::pair<size_t, std::vector<ClientInfo>> sampleRoster(size_t count);
+
+  // Sharded coordinator mode: clients are partitioned across shard_peers by
+  // consistent hashing of client_id. The shard that creates an event samples
+  // participants from every shard and aggregates their results.
+  HashRing shard_ring_;
+  std::string shard_self_; // This shard's "host:port" on the ring
+  bool sharded() const { return !shard_ring_.empty(); }
+  std::vector<ClientInfo> selectParticipantsAcrossShards(int extra_participants);
   // Configuration
   ServerConfig config_;
 
@@ -62,7 +114,7 @@ private:
   ConnectionPool connection_pool_;
 
   // Transport Layer Management (read-heavy: peer queries, participant selection)
-  std::unordered_map<std::string, ClientState> roster_;
+  Roster roster_;
   std::shared_mutex roster_mutex_;
 
   // Private Methods
@@ -71,41 +123,107 @@ private:
   void handleEndpointConnect(const httplib::Request &, httplib::Response &);
   void handleEndpointPeers(const httplib::Request &, httplib::Response &);
   void handleEndpointPing(const httplib::Request &, httplib::Response &);
+  void handleEndpointShardRosterSample(const httplib::Request &, httplib::Response &);
 
   // Event/Response Aggregation/Processing
   // Read-heavy: multiple threads checking completion status
   std::unordered_map<std::string,
                      std::unordered_map<std::string, EventResponse>>
       unprocessed_responses_;
+  // Lock order: active_events_mutex_ before unprocessed_responses_mutex_
+  // whenever both are held
   std::shared_mutex unprocessed_responses_mutex_;
-  std::queue<Event> pending_events_;
-  std::mutex event_mutex_;
 
-  // MPC modules
-  std::unordered_map<std::string, std::unique_ptr<MPCModule>>
-      modules_;
-  std::shared_mutex modules_mutex_;
+  // Event scheduler: events queued by submitEvent() and the recurring
+  // scheduled_computation_type, announced while under max_events_in_flight
+  struct PendingEvent {
+    EventType type;
+    std::string event_id;
+    std::string computation_type;
+    nlohmann::json computation_metadata;
+    std::shared_ptr<EventCompletion> completion;
+    // Submission + event_timeout_boundary; past it, too few clients times it out
+    std::chrono::steady_clock::time_point deadline;
+  };
+  std::deque<PendingEvent> pending_events_;
+  std::mutex event_mutex_;
+  std::condition_variable scheduler_cv_;
+  int announcing_events_ = 0; // Fan-out threads still running (stop_mutex_)
+  std::thread scheduler_thread_;
+  void eventScheduler();
+  int eventsInFlight();
+  std::unordered_set<std::string> busyParticipants();
+  std::optional<Event> buildEvent(EventType type, const std::string &event_id,
+                                  const std::string &computation_type,
+                                  const nlohmann::json &computation_metadata,
+                                  const std::unordered_set<std::string> &avoid);
+  // Registers the event as active; sendAnnouncements() then delivers it.
+  // Returns false, having failed the completion, if the ID is already active.
+  bool openEvent(const Event &event, std::shared_ptr<EventCompletion> completion);
+  void sendAnnouncements(const Event &event);
+
+  // MPC modules; each event binds its module when it is opened
+  ModuleRegistry modules_;
 
   // Active event tracking (read-heavy: status checks, completion monitoring)
   struct ActiveEvent {
     std::string event_id;
     std::string computation_type;
     int expected_participants;
+    int threshold; // Responses needed to aggregate on timeout (module threshold)
+    int quorum;    // Contributing participants that finalize the event immediately
     std::chrono::time_point<std::chrono::steady_clock> created_time;
-    std::string *result_ptr = nullptr; // Optional pointer to store final result
+    // Notified once when the event finalizes or fails; null for events
+    // recovered from disk, whose caller is gone
+    std::shared_ptr<EventCompletion> completion;
+    // Bound when the event opens; null for events recovered before their
+    // module was registered, which resolve it at finalization
+    ModuleRegistry::Handle module;
     const Event event;
   };
   std::unordered_map<std::string, ActiveEvent> active_events_;
+  // Taken before unprocessed_responses_mutex_ when both are held
   std::shared_mutex active_events_mutex_;
 
+  // Event timeouts, ordered by deadline (created_time + event_timeout_boundary)
+  DeadlineQueue<std::string> event_deadlines_;
+
+  using ActiveEventNode = decltype(active_events_)::node_type;
+  using ResponsesNode = decltype(unprocessed_responses_)::node_type;
+
   // Private methods
   void checkForCompleteResults();
-  void periodicEventChecker();
+  std::vector<std::pair<ActiveEventNode, ResponsesNode>>
+  claimEvents(const std::vector<std::string> &event_ids);
+  void finalizeEvent(const ActiveEvent &active_event,
+                     const std::unordered_map<std::string, EventResponse> &responses,
+                     bool degraded);
+  void finalizeWithModule(const ActiveEvent &active_event,
+                          const std::unordered_map<std::string, EventResponse> &responses,
+                          bool degraded, EventOutcome &outcome);
+  int requiredResponses(const MPCModule *module, int expected_participants);
+  void recordParticipation(
+      const std::vector<std::pair<std::string, bool>> &outcomes);
+  void eventDeadlineChecker();
+
+  // Durable state (null when persistence is disabled). Every mutation of the
+  // roster, active events or responses is logged while holding that state's
+  // lock, so a snapshot taken under all three locks is a consistent cut.
+  std::unique_ptr<StateStore> state_store_;
+  void recoverState();
+  void applyStateRecord(const nlohmann::json &record);
+  uint64_t logState(nlohmann::json record); // Returns 0 when disabled
+  void awaitState(uint64_t seq);
+  void writeSnapshot();
+  void periodicSnapshotter();
 
   // Background threads
   std::thread checker_thread_;
   std::thread ping_thread_;
+  std::thread snapshot_thread_;
   std::atomic<bool> should_stop_{false};
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_; // Wakes sleeping background threads on stop()
   
   void periodicPinger();
   
@@ -115,7 +233,13 @@ private:
   std::unique_ptr<httplib::SSLServer> ssl_svr_;
 #endif
   
+  // Worker pool of the running HTTP server; owned by httplib while listening
+  std::atomic<BoundedTaskQueue*> http_queue_{nullptr};
+
   // Setup routes for either server type
   template<typename ServerType>
   void setupRoutesForServer(ServerType* server);
+  // Apply worker pool, load shedding and request limits from config_
+  template<typename ServerType>
+  void configureHttpServer(ServerType* server);
 };
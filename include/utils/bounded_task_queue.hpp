@@ -0,0 +1,93 @@
+#pragma once
+#include <httplib.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool for httplib::Server with a bounded backlog.
+//
+// httplib hands one accepted connection to the queue per task. Once
+// max_queued connections are waiting, saturated() turns true so request
+// handlers can shed load with a cheap 503. enqueue() fails outright at
+// hard_limit, and httplib then closes the socket, so memory stays bounded
+// even if shedding falls behind.
+class BoundedTaskQueue : public httplib::TaskQueue {
+public:
+    BoundedTaskQueue(size_t worker_count, size_t max_queued, size_t hard_limit)
+        : max_queued_(max_queued), hard_limit_(hard_limit) {
+        workers_.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; i++) {
+            workers_.emplace_back(&BoundedTaskQueue::workerLoop, this);
+        }
+    }
+
+    ~BoundedTaskQueue() override { shutdown(); }
+
+    bool enqueue(std::function<void()> fn) override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_ || (hard_limit_ > 0 && jobs_.size() >= hard_limit_)) {
+                rejected_++;
+                return false;
+            }
+            jobs_.push_back(std::move(fn));
+            queued_ = jobs_.size();
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    // Runs the jobs already queued, then joins the workers
+    void shutdown() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (shutdown_) {
+                return;
+            }
+            shutdown_ = true;
+        }
+        cv_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    bool saturated() const { return max_queued_ > 0 && queued_ >= max_queued_; }
+    size_t queued() const { return queued_; }
+    size_t rejected() const { return rejected_; }
+
+private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return shutdown_ || !jobs_.empty(); });
+                if (jobs_.empty()) {
+                    return; // Shut down and drained
+                }
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+                queued_ = jobs_.size();
+            }
+            job();
+        }
+    }
+
+    const size_t max_queued_;
+    const size_t hard_limit_;
+
+    std::deque<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool shutdown_ = false;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> rejected_{0};
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+// Hash map split into independently locked shards, so operations on keys in
+// different shards never contend. Values are returned by copy, which makes
+// this a map of handles: store std::shared_ptr and lock the pointee for
+// per-entry state.
+template <typename Key, typename Value, size_t ShardCount = 16>
+class ConcurrentMap {
+public:
+    // Value{} when absent
+    Value find(const Key& key) const {
+        const Shard& shard = shardFor(key);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        return it != shard.map.end() ? it->second : Value{};
+    }
+
+    // Inserts make() unless key is present. Returns the stored value and
+    // whether it was inserted; make() only runs when it is.
+    template <typename Make>
+    std::pair<Value, bool> findOrInsert(const Key& key, Make&& make) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            return {it->second, false};
+        }
+        auto [inserted, _] = shard.map.emplace(key, make());
+        return {inserted->second, true};
+    }
+
+    // Erases key only while it still maps to expected, so a stale handle
+    // never removes a newer entry
+    bool eraseIf(const Key& key, const Value& expected) {
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end() || !(it->second == expected)) {
+            return false;
+        }
+        shard.map.erase(it);
+        return true;
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            total += shard.map.size();
+        }
+        return total;
+    }
+
+    // Visits every entry one shard at a time; not a consistent snapshot
+    // across shards. fn must not call back into the map.
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Shard& shard : shards_) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto& [key, value] : shard.map) {
+                fn(key, value);
+            }
+        }
+    }
+
+private:
+    // Own cache line each, so shard locks do not false-share
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<Key, Value> map;
+    };
+
+    Shard& shardFor(const Key& key) { return shards_[std::hash<Key>{}(key) % ShardCount]; }
+    const Shard& shardFor(const Key& key) const {
+        return shards_[std::hash<Key>{}(key) % ShardCount];
+    }
+
+    std::array<Shard, ShardCount> shards_;
+};
@@ -0,0 +1,85 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+// Deadline-ordered min-heap with a blocking wait for the next expiry.
+// Entries are never cancelled; consumers must re-check whether a key is still
+// pending when it pops out (lazy deletion keeps schedule() O(log n)).
+template <typename Key>
+class DeadlineQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void schedule(const Key& key, Clock::time_point deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bool new_earliest = heap_.empty() || deadline < heap_.top().deadline;
+            heap_.push(Entry{deadline, key});
+            if (!new_earliest) {
+                return; // The waiter is already sleeping until an earlier deadline
+            }
+        }
+        cv_.notify_all();
+    }
+
+    // Blocks until at least one deadline has passed and returns all expired
+    // keys in deadline order. Returns an empty vector once stop() is called.
+    std::vector<Key> waitExpired() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stopped_) {
+            if (heap_.empty()) {
+                cv_.wait(lock);
+                continue;
+            }
+
+            auto now = Clock::now();
+            if (heap_.top().deadline <= now) {
+                std::vector<Key> expired;
+                while (!heap_.empty() && heap_.top().deadline <= now) {
+                    expired.push_back(heap_.top().key);
+                    heap_.pop();
+                }
+                return expired;
+            }
+
+            cv_.wait_until(lock, heap_.top().deadline);
+        }
+        return {};
+    }
+
+    // Wakes all waiters immediately; waitExpired() returns empty until start()
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = false;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return heap_.size();
+    }
+
+private:
+    struct Entry {
+        Clock::time_point deadline;
+        Key key;
+
+        bool operator>(const Entry& other) const { return deadline > other.deadline; }
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopped_ = false;
+};
@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// Time-bucketed set of recently seen 64-bit keys, for duplicate suppression.
+//
+// Time is cut into slices of ttl / generations. Each slice owns an
+// open-addressing table of hashes, and expiry resets a whole slice at once
+// instead of walking entries. A key is remembered for between ttl and
+// ttl + one slice. Keys are striped over independently locked shards, and
+// tables are reused across rotations, so steady-state checks do not allocate.
+class RotatingDedupFilter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RotatingDedupFilter(std::chrono::milliseconds ttl,
+                                 size_t generations = 4,
+                                 size_t stripes = 16,
+                                 size_t initial_capacity = 64)
+        : slice_ms_(std::max<int64_t>(1, ttl.count() / static_cast<int64_t>(std::max<size_t>(1, generations)))),
+          generations_(std::max<size_t>(1, generations)),
+          stripe_mask_(roundUpPow2(stripes) - 1),
+          stripes_(new Stripe[stripe_mask_ + 1]) {
+        for (size_t i = 0; i <= stripe_mask_; i++) {
+            // One extra table so the oldest live slice is never the one reset
+            stripes_[i].tables.resize(generations_ + 1);
+            for (auto& table : stripes_[i].tables) {
+                table.slots.assign(roundUpPow2(initial_capacity), EMPTY);
+            }
+        }
+    }
+
+    // Records the key and returns true if it was not seen within the TTL
+    bool insertIfAbsent(uint64_t key, Clock::time_point now = Clock::now()) {
+        if (key == EMPTY) {
+            key = 1;
+        }
+        int64_t epoch = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            now.time_since_epoch()).count() / slice_ms_;
+
+        Stripe& stripe = stripes_[(key >> 56) & stripe_mask_];
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+
+        for (const auto& table : stripe.tables) {
+            if (table.epoch >= epoch - static_cast<int64_t>(generations_) &&
+                table.size > 0 && contains(table, key)) {
+                return false;
+            }
+        }
+
+        Table& current = stripe.tables[epoch % stripe.tables.size()];
+        if (current.epoch < epoch) {
+            // Dropping an expired slice is a single reset of its table
+            std::fill(current.slots.begin(), current.slots.end(), EMPTY);
+            current.size = 0;
+            current.epoch = epoch;
+        }
+        if ((current.size + 1) * 2 > current.slots.size()) {
+            grow(current);
+        }
+        insert(current, key);
+        return true;
+    }
+
+    // Order-sensitive hash of two strings, without concatenating them
+    static uint64_t hashPair(std::string_view a, std::string_view b) {
+        uint64_t h = std::hash<std::string_view>{}(a);
+        h ^= std::hash<std::string_view>{}(b) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        // splitmix64 finalizer spreads the bits used for striping
+        h ^= h >> 30;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27;
+        h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+private:
+    static constexpr uint64_t EMPTY = 0;
+
+    struct Table {
+        int64_t epoch = -1;
+        size_t size = 0;
+        std::vector<uint64_t> slots; // Power-of-two capacity, linear probing
+    };
+
+    struct alignas(64) Stripe {
+        std::mutex mutex;
+        std::vector<Table> tables;
+    };
+
+    static size_t roundUpPow2(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    static bool contains(const Table& table, uint64_t key) {
+        size_t mask = table.slots.size() - 1;
+        for (size_t i = key & mask;; i = (i + 1) & mask) {
+            if (table.slots[i] == key) return true;
+            if (table.slots[i] == EMPTY) return false;
+        }
+    }
+
+    static void insert(Table& table, uint64_t key) {
+        size_t mask = table.slots.size() - 1;
+        size_t i = key & mask;
+        while (table.slots[i] != EMPTY) {
+            i = (i + 1) & mask;
+        }
+        table.slots[i] = key;
+        table.size++;
+    }
+
+    static void grow(Table& table) {
+        std::vector<uint64_t> old(table.slots.size() * 2, EMPTY);
+        old.swap(table.slots);
+        table.size = 0;
+        for (uint64_t key : old) {
+            if (key != EMPTY) {
+                insert(table, key);
+            }
+        }
+    }
+
+    int64_t slice_ms_;
+    size_t generations_;
+    size_t stripe_mask_;
+    std::unique_ptr<Stripe[]> stripes_;
+};
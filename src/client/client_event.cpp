@@ -0,0 +1,123 @@
+#include "client/client_event.hpp"
+
+namespace {
+
+size_t approxEventBytes(const Event &event) {
+  size_t bytes = sizeof(Event) + event.event_id.size() +
+                 event.computation_type.size() + event.server_signature.size() +
+                 event.aggregator.size() + event.computation_metadata.dump().size();
+  for (const auto &participant : event.participants) {
+    bytes += sizeof(ClientInfo) + participant.client_id.size() +
+             participant.client_host.size() + participant.client_port.size() +
+             participant.ed25519_pub.size();
+  }
+  return bytes;
+}
+
+} // namespace
+
+ClientEvent::ClientEvent(Event event, std::shared_ptr<MPCModule> module,
+                         Clock::time_point expires)
+    : event(std::move(event)), event_bytes(approxEventBytes(this->event)),
+      module(std::move(module)),
+      received_bits_(std::make_unique<std::atomic<uint64_t>[]>(
+          (this->event.participants.size() + 63) / 64)),
+      arena_(std::make_unique<EventArena>(this->event.participants.size())),
+      expires_(expires) {
+  shard_views_.reserve(this->event.participants.size());
+  participant_index_.reserve(this->event.participants.size());
+  for (size_t i = 0; i < this->event.participants.size(); i++) {
+    participant_index_.emplace(this->event.participants[i].client_id, i);
+  }
+}
+
+std::optional<size_t>
+ClientEvent::participantIndex(const std::string &client_id) const {
+  auto it = participant_index_.find(client_id);
+  if (it == participant_index_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+size_t ClientEvent::markReceived(size_t index) {
+  uint64_t bit = uint64_t{1} << (index % 64);
+  if (received_bits_[index / 64].fetch_or(bit, std::memory_order_acq_rel) & bit) {
+    return 0; // A resend
+  }
+  return shards_received_.fetch_add(1, std::memory_order_acq_rel) + 1;
+}
+
+bool ClientEvent::storeShard(size_t index, std::string_view data) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (arena_ && !shards_frozen_) {
+      arena_->storeShard(index, data);
+    }
+  }
+  // Marked after the data is in place, so whoever sees the event complete
+  // also sees every shard. Each arrival gets its own count, so only the one
+  // that completes the event returns true.
+  return markReceived(index) == event.participants.size();
+}
+
+std::span<const ShardView> ClientEvent::freezeShards() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!arena_) {
+    return {};
+  }
+  if (!shards_frozen_) {
+    shards_frozen_ = true;
+    const auto &stored = arena_->shards();
+    for (size_t i = 0; i < stored.size(); i++) {
+      if (received_bits_[i / 64].load(std::memory_order_acquire) &
+          (uint64_t{1} << (i % 64))) {
+        shard_views_.push_back(ShardView{i, stored[i]});
+      }
+    }
+  }
+  return shard_views_;
+}
+
+void ClientEvent::releaseShards() {
+  std::unique_ptr<EventArena> arena;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    arena = std::move(arena_);
+    shard_views_.clear();
+  }
+  // Freed outside the lock
+}
+
+size_t ClientEvent::arenaBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return arena_ ? arena_->bytesReserved() : 0;
+}
+
+EventPhase ClientEvent::phase() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return phase_;
+}
+
+void ClientEvent::advance(EventPhase phase) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (phase > phase_) {
+    phase_ = phase;
+  }
+}
+
+void ClientEvent::expireNow(Clock::time_point now) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  phase_ = EventPhase::Expired;
+  expires_ = now;
+}
+
+ClientEvent::Clock::time_point ClientEvent::expires() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return expires_;
+}
+
+void ClientEvent::setExpires(Clock::time_point expires) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  expires_ = expires;
+}
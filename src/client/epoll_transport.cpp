@@ -0,0 +1,526 @@
+#include "client/epoll_transport.hpp"
+#include "utils/logging.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <string_view>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char *reasonPhrase(int status) {
+  switch (status) {
+  case 200: return "OK";
+  case 400: return "Bad Request";
+  case 404: return "Not Found";
+  case 411: return "Length Required";
+  case 413: return "Payload Too Large";
+  case 431: return "Request Header Fields Too Large";
+  case 500: return "Internal Server Error";
+  case 503: return "Service Unavailable";
+  default: return status < 400 ? "OK" : "Error";
+  }
+}
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+    s.remove_prefix(1);
+  }
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+    s.remove_suffix(1);
+  }
+  return s;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+  return a.size() == b.size() &&
+         std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+           return std::tolower(static_cast<unsigned char>(x)) ==
+                  std::tolower(static_cast<unsigned char>(y));
+         });
+}
+
+} // namespace
+
+EpollTransport &EpollTransport::Post(const std::string &path, Handler handler) {
+  post_handlers_[path] = std::move(handler);
+  return *this;
+}
+
+bool EpollTransport::listen(const std::string &host, int port) {
+  return bind_to_port(host, port) && listen_after_bind();
+}
+
+void EpollTransport::dispatch(const httplib::Request &req,
+                              httplib::Response &res) {
+  auto it = req.method == "POST" ? post_handlers_.find(req.path)
+                                 : post_handlers_.end();
+  if (it == post_handlers_.end()) {
+    res.status = 404;
+    return;
+  }
+
+  try {
+    it->second(req, res);
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Unhandled exception in handler for " << req.path << ": "
+                                                      << e.what());
+    res.status = 500;
+    res.body.clear();
+  }
+  if (res.status == -1) {
+    res.status = 200;
+  }
+}
+
+void EpollTransport::appendResponse(Connection &conn,
+                                    const httplib::Response &res,
+                                    bool keep_alive) {
+  std::string &out = conn.out;
+  out += "HTTP/1.1 ";
+  out += std::to_string(res.status);
+  out += ' ';
+  out += reasonPhrase(res.status);
+  out += "\r\n";
+  for (const auto &[name, value] : res.headers) {
+    if (iequals(name, "Content-Length") || iequals(name, "Connection")) {
+      continue;
+    }
+    out += name;
+    out += ": ";
+    out += value;
+    out += "\r\n";
+  }
+  out += "Content-Length: ";
+  out += std::to_string(res.body.size());
+  out += keep_alive ? "\r\nConnection: keep-alive\r\n\r\n"
+                    : "\r\nConnection: close\r\n\r\n";
+  out += res.body;
+}
+
+bool EpollTransport::processRequests(Connection &conn) {
+  size_t consumed = 0;
+  bool keep_open = true;
+
+  while (keep_open) {
+    std::string_view pending(conn.in.data() + consumed,
+                             conn.in.size() - consumed);
+    size_t header_end = pending.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) {
+      if (pending.size() > MAX_HEADER_BYTES) {
+        httplib::Response res;
+        res.status = 431;
+        appendResponse(conn, res, false);
+        keep_open = false;
+      }
+      break;
+    }
+
+    httplib::Request req;
+    httplib::Response res;
+    std::string_view head = pending.substr(0, header_end);
+
+    // Request line: METHOD SP TARGET SP VERSION
+    size_t line_end = head.find("\r\n");
+    std::string_view request_line = head.substr(0, line_end);
+    size_t sp1 = request_line.find(' ');
+    size_t sp2 = request_line.rfind(' ');
+    if (sp1 == std::string_view::npos || sp2 == sp1) {
+      res.status = 400;
+      appendResponse(conn, res, false);
+      keep_open = false;
+      break;
+    }
+    req.method = std::string(request_line.substr(0, sp1));
+    std::string_view target = request_line.substr(sp1 + 1, sp2 - sp1 - 1);
+    req.path = std::string(target.substr(0, target.find('?')));
+    std::string_view version = request_line.substr(sp2 + 1);
+
+    // Headers
+    bool keep_alive = version == "HTTP/1.1";
+    bool chunked = false;
+    size_t content_length = 0;
+    std::string_view rest =
+        line_end == std::string_view::npos ? "" : head.substr(line_end + 2);
+    while (!rest.empty()) {
+      size_t eol = rest.find("\r\n");
+      std::string_view line = rest.substr(0, eol);
+      rest = eol == std::string_view::npos ? "" : rest.substr(eol + 2);
+
+      size_t colon = line.find(':');
+      if (colon == std::string_view::npos) {
+        continue;
+      }
+      std::string_view name = trim(line.substr(0, colon));
+      std::string_view value = trim(line.substr(colon + 1));
+      if (iequals(name, "Content-Length")) {
+        content_length = std::strtoull(std::string(value).c_str(), nullptr, 10);
+      } else if (iequals(name, "Transfer-Encoding")) {
+        chunked = true;
+      } else if (iequals(name, "Connection")) {
+        if (iequals(value, "close")) {
+          keep_alive = false;
+        } else if (iequals(value, "keep-alive")) {
+          keep_alive = true;
+        }
+      }
+      req.headers.emplace(std::string(name), std::string(value));
+    }
+
+    if (chunked || content_length > payload_max_length_) {
+      res.status = chunked ? 411 : 413;
+      appendResponse(conn, res, false);
+      keep_open = false;
+      break;
+    }
+
+    size_t request_size = header_end + 4 + content_length;
+    if (pending.size() < request_size) {
+      break; // Body not fully received yet
+    }
+
+    req.body = std::string(pending.substr(header_end + 4, content_length));
+    req.remote_addr = conn.remote_addr;
+    req.remote_port = conn.remote_port;
+    consumed += request_size;
+
+    dispatch(req, res);
+    appendResponse(conn, res, keep_alive);
+    keep_open = keep_alive;
+  }
+
+  // Compact once per read instead of once per request; capacity is kept
+  conn.in.erase(0, consumed);
+  return keep_open;
+}
+
+#ifdef __linux__
+
+EpollTransport::EpollTransport() : read_buffer_(64 * 1024) {
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+EpollTransport::~EpollTransport() {
+  stop();
+  if (listen_fd_ >= 0) {
+    close(listen_fd_);
+  }
+  if (wake_fd_ >= 0) {
+    close(wake_fd_);
+  }
+}
+
+bool EpollTransport::bind_to_port(const std::string &host, int port) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  hints.ai_flags = AI_PASSIVE;
+
+  addrinfo *result = nullptr;
+  std::string service = std::to_string(port);
+  if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0) {
+    DEBUG_ERROR("Failed to resolve listen host " << host);
+    return false;
+  }
+
+  for (addrinfo *ai = result; ai != nullptr; ai = ai->ai_next) {
+    int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    ai->ai_protocol);
+    if (fd < 0) {
+      continue;
+    }
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    if (::bind(fd, ai->ai_addr, ai->ai_addrlen) == 0 &&
+        ::listen(fd, SOMAXCONN) == 0) {
+      listen_fd_ = fd;
+      break;
+    }
+    close(fd);
+  }
+  freeaddrinfo(result);
+
+  if (listen_fd_ < 0) {
+    DEBUG_ERROR("Failed to bind " << host << ":" << port << ": "
+                                  << std::strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool EpollTransport::listen_after_bind() {
+  if (listen_fd_ < 0 || wake_fd_ < 0) {
+    return false;
+  }
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    DEBUG_ERROR("epoll_create1 failed: " << std::strerror(errno));
+    return false;
+  }
+
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLET;
+  ev.data.fd = listen_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev);
+  ev.events = EPOLLIN;
+  ev.data.fd = wake_fd_;
+  epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+  running_ = true;
+  DEBUG_INFO("Epoll transport listening");
+
+  epoll_event events[MAX_EVENTS];
+  auto last_sweep = std::chrono::steady_clock::now();
+  while (!stop_requested_) {
+    int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, 1000);
+    if (n < 0 && errno != EINTR) {
+      DEBUG_ERROR("epoll_wait failed: " << std::strerror(errno));
+      break;
+    }
+
+    for (int i = 0; i < n; i++) {
+      int fd = events[i].data.fd;
+      if (fd == wake_fd_) {
+        continue; // Woken by stop()
+      }
+      if (fd == listen_fd_) {
+        acceptConnections();
+        continue;
+      }
+
+      auto it = connections_.find(fd);
+      if (it == connections_.end()) {
+        continue; // Closed earlier in this batch
+      }
+      Connection &conn = *it->second;
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        closeConnection(fd);
+        continue;
+      }
+      if (events[i].events & EPOLLIN) {
+        handleReadable(conn);
+        if (connections_.find(fd) == connections_.end()) {
+          continue;
+        }
+      }
+      if (events[i].events & EPOLLOUT) {
+        handleWritable(conn);
+      }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_sweep >= std::chrono::seconds(1)) {
+      closeIdleConnections();
+      last_sweep = now;
+    }
+  }
+
+  while (!connections_.empty()) {
+    closeConnection(connections_.begin()->first);
+  }
+  close(epoll_fd_);
+  epoll_fd_ = -1;
+  close(listen_fd_);
+  listen_fd_ = -1;
+  running_ = false;
+  return true;
+}
+
+void EpollTransport::stop() {
+  stop_requested_ = true;
+  if (wake_fd_ >= 0) {
+    uint64_t one = 1;
+    ssize_t written = write(wake_fd_, &one, sizeof(one));
+    (void)written;
+  }
+}
+
+void EpollTransport::acceptConnections() {
+  // Edge-triggered: drain the whole accept backlog
+  while (true) {
+    sockaddr_storage addr{};
+    socklen_t addr_len = sizeof(addr);
+    int fd = accept4(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &addr_len,
+                     SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        DEBUG_ERROR("accept failed: " << std::strerror(errno));
+      }
+      return;
+    }
+
+    int yes = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+    auto conn = acquireConnection();
+    conn->fd = fd;
+    conn->last_active = std::chrono::steady_clock::now();
+    char host[INET6_ADDRSTRLEN] = {0};
+    if (addr.ss_family == AF_INET) {
+      auto *in = reinterpret_cast<sockaddr_in *>(&addr);
+      inet_ntop(AF_INET, &in->sin_addr, host, sizeof(host));
+      conn->remote_port = ntohs(in->sin_port);
+    } else if (addr.ss_family == AF_INET6) {
+      auto *in6 = reinterpret_cast<sockaddr_in6 *>(&addr);
+      inet_ntop(AF_INET6, &in6->sin6_addr, host, sizeof(host));
+      conn->remote_port = ntohs(in6->sin6_port);
+    }
+    conn->remote_addr = host;
+
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      close(fd);
+      releaseConnection(std::move(conn));
+      continue;
+    }
+    connections_[fd] = std::move(conn);
+  }
+}
+
+void EpollTransport::handleReadable(Connection &conn) {
+  bool peer_closed = false;
+  while (true) {
+    ssize_t n = recv(conn.fd, read_buffer_.data(), read_buffer_.size(), 0);
+    if (n > 0) {
+      conn.in.append(read_buffer_.data(), n);
+      continue;
+    }
+    if (n == 0) {
+      peer_closed = true;
+    } else if (errno == EINTR) {
+      continue;
+    } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      closeConnection(conn.fd);
+      return;
+    }
+    break;
+  }
+  conn.last_active = std::chrono::steady_clock::now();
+
+  if (!conn.close_after_write && !processRequests(conn)) {
+    conn.close_after_write = true;
+  }
+  if (peer_closed) {
+    conn.close_after_write = true;
+  }
+  handleWritable(conn);
+}
+
+void EpollTransport::handleWritable(Connection &conn) {
+  while (conn.out_offset < conn.out.size()) {
+    ssize_t n = send(conn.fd, conn.out.data() + conn.out_offset,
+                     conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+    if (n > 0) {
+      conn.out_offset += n;
+      continue;
+    }
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return; // EPOLLOUT fires again when the socket drains
+    }
+    closeConnection(conn.fd);
+    return;
+  }
+
+  conn.out.clear();
+  conn.out_offset = 0;
+  if (conn.close_after_write) {
+    closeConnection(conn.fd);
+  }
+}
+
+void EpollTransport::closeConnection(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) {
+    return;
+  }
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  auto conn = std::move(it->second);
+  connections_.erase(it);
+  releaseConnection(std::move(conn));
+}
+
+void EpollTransport::closeIdleConnections() {
+  auto cutoff = std::chrono::steady_clock::now() - keep_alive_timeout_;
+  std::vector<int> idle;
+  for (const auto &[fd, conn] : connections_) {
+    if (conn->last_active < cutoff) {
+      idle.push_back(fd);
+    }
+  }
+  for (int fd : idle) {
+    closeConnection(fd);
+  }
+}
+
+#else
+
+EpollTransport::EpollTransport() = default;
+EpollTransport::~EpollTransport() = default;
+
+bool EpollTransport::bind_to_port(const std::string &host, int port) {
+  DEBUG_ERROR("Epoll transport is only available on Linux");
+  return false;
+}
+
+bool EpollTransport::listen_after_bind() { return false; }
+void EpollTransport::stop() {}
+void EpollTransport::acceptConnections() {}
+void EpollTransport::handleReadable(Connection &conn) {}
+void EpollTransport::handleWritable(Connection &conn) {}
+void EpollTransport::closeConnection(int fd) {}
+void EpollTransport::closeIdleConnections() {}
+
+#endif
+
+std::unique_ptr<EpollTransport::Connection> EpollTransport::acquireConnection() {
+  if (free_connections_.empty()) {
+    return std::make_unique<Connection>();
+  }
+  auto conn = std::move(free_connections_.back());
+  free_connections_.pop_back();
+  return conn;
+}
+
+void EpollTransport::releaseConnection(std::unique_ptr<Connection> conn) {
+  // Keep buffer capacity, but don't let one huge request pin memory forever
+  static constexpr size_t MAX_RETAINED_BUFFER = 256 * 1024;
+  static constexpr size_t MAX_FREE_CONNECTIONS = 64;
+  if (free_connections_.size() >= MAX_FREE_CONNECTIONS) {
+    return;
+  }
+  conn->fd = -1;
+  conn->in.clear();
+  conn->out.clear();
+  conn->out_offset = 0;
+  conn->close_after_write = false;
+  conn->remote_addr.clear();
+  conn->remote_port = -1;
+  if (conn->in.capacity() > MAX_RETAINED_BUFFER) {
+    conn->in.shrink_to_fit();
+  }
+  if (conn->out.capacity() > MAX_RETAINED_BUFFER) {
+    conn->out.shrink_to_fit();
+  }
+  free_connections_.push_back(std::move(conn));
+}
@@ -2,9 +2,12 @@
 #include "crypto/signature.hpp"
 #include "protocol/parser.hpp"
 #include "utils/logging.hpp"
+#include <algorithm>
 #include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <optional>
 #include <random>
 #include <shared_mutex>
 #include <sstream>
@@ -38,6 +41,9 @@ TribuneClient::TribuneClient(const std::string &seed_host, int seed_port,
   // Configure connection pool for TLS if enabled
   connection_pool_.setUseTLS(config_.use_tls);
 
+  if (config_.transport == "epoll") {
+    epoll_transport_ = std::make_unique<EpollTransport>();
+  }
   setupEventRoutes();
 
   LOG("Created TribuneClient with ID: " << client_id_);
@@ -56,8 +62,7 @@ void TribuneClient::setDataCollectionModule(
 
 void TribuneClient::registerModule(const std::string &type,
                                    std::unique_ptr<MPCModule> module) {
-  std::unique_lock<std::shared_mutex> lock(modules_mutex_);
-  modules_[type] = std::move(module);
+  modules_.add(type, std::move(module));
   DEBUG_INFO("Registered MPC module: " << type);
 }
 
@@ -93,6 +98,21 @@ bool TribuneClient::connectToSeed() {
           return cli->Post("/connect", json_body, "application/json");
         });
 
+    // A sharded coordinator redirects us to the shard that owns our ID; that
+    // shard becomes our server for pings and submissions
+    static constexpr int MAX_REDIRECTS = 3;
+    for (int hops = 0; hops < MAX_REDIRECTS && res && res->status == 307; hops++) {
+      std::string owner = nlohmann::json::parse(res->body).at("redirect");
+      size_t colon = owner.rfind(':');
+      seed_host_ = owner.substr(0, colon);
+      seed_port_ = std::stoi(owner.substr(colon + 1));
+      DEBUG_INFO("Redirected to shard " << seed_host_ << ":" << seed_port_);
+
+      res = connection_pool_.withConnection(seed_host_, seed_port_, [&](auto *cli) {
+        return cli->Post("/connect", json_body, "application/json");
+      });
+    }
+
     if (res && res->status == 200) {
       LOG("Successfully connected to seed node!");
       DEBUG_DEBUG("Response: " << res->body);
@@ -126,9 +146,18 @@ bool TribuneClient::connectToSeed() {
   }
 }
 
+void TribuneClient::addEventRoute(const std::string &path,
+                                  httplib::Server::Handler handler) {
+  if (epoll_transport_) {
+    epoll_transport_->Post(path, std::move(handler));
+  } else {
+    event_server_.Post(path, std::move(handler));
+  }
+}
+
 void TribuneClient::setupEventRoutes() {
   // Setup the /event endpoint to receive announcements
-  event_server_.Post(
+  addEventRoute(
       "/event", [this](const httplib::Request &req, httplib::Response &res) {
         try {
           DEBUG_DEBUG("Received event announcement: " << req.body);
@@ -140,8 +169,19 @@ void TribuneClient::setupEventRoutes() {
           DEBUG_DEBUG("Received event from server with signature: '"
                       << event.server_signature << "'");
 
-          // Handle the event
-          onEventAnnouncement(event);
+          // Handle the event. The epoll transport serves every connection
+          // from one thread, so the blocking fan-out to peers runs elsewhere
+          if (epoll_transport_) {
+            if (!epoll_workers_->enqueue([this, event = std::move(event)]() {
+                  onEventAnnouncement(event);
+                })) {
+              res.status = 503;
+              res.set_content("{\"error\":\"Client busy\"}", "application/json");
+              return;
+            }
+          } else {
+            onEventAnnouncement(event);
+          }
 
           // Send response
           res.status = 200;
@@ -155,15 +195,53 @@ void TribuneClient::setupEventRoutes() {
         }
       });
 
-  event_server_.Post(
+  addEventRoute(
       "/ping", [this](const httplib::Request &req, httplib::Response &res) {
         res.status = 200;
         res.set_content("{\"status\":\"pong\"}", "application/json");
       });
 
+  // Setup the /partial endpoint to receive subtree partials from our children
+  // in an aggregation tree
+  addEventRoute("/partial", [this](const httplib::Request &req,
+                                   httplib::Response &res) {
+    try {
+      TreePartialMessage msg = nlohmann::json::parse(req.body).get<TreePartialMessage>();
+
+      std::shared_ptr<ClientEvent> client_event;
+      res.status = verifyTreePartial(msg, client_event);
+      if (res.status != 200) {
+        res.set_content("{\"error\":\"Rejected partial\"}", "application/json");
+        return;
+      }
+
+      // Completing the bundle forwards it upward, which must not block the
+      // epoll loop
+      if (epoll_transport_) {
+        if (!epoll_workers_->enqueue([this, client_event = std::move(client_event),
+                                      msg = std::move(msg)]() mutable {
+              addTreePartials(*client_event, msg.from_client, std::move(msg.bundle));
+            })) {
+          res.status = 503;
+          res.set_content("{\"error\":\"Client busy\"}", "application/json");
+          return;
+        }
+      } else {
+        addTreePartials(*client_event, msg.from_client, std::move(msg.bundle));
+      }
+      res.set_content("{\"status\":\"received\"}", "application/json");
+
+    } catch (const std::exception &e) {
+      DEBUG_ERROR("Error processing tree partial: " << e.what());
+      res.status = 400;
+      res.set_content("{\"error\":\"Failed to process partial\"}",
+                      "application/json");
+    }
+  });
+
   // Setup the /peer-data endpoint to receive data from other clients
-  event_server_.Post("/peer-data", [this](const httplib::Request &req,
-                                          httplib::Response &res) {
+  addEventRoute("/peer-data", [this](const httplib::Request &req,
+                                     httplib::Response &res) {
     try {
 
       // Parse the peer data message
@@ -213,6 +291,14 @@ void TribuneClient::startListening() {
   }
 
   running_ = true;
+  if (epoll_transport_) {
+    epoll_workers_ = std::make_unique<BoundedTaskQueue>(EPOLL_WORKER_THREADS, 0,
+                                                        EPOLL_MAX_QUEUED_JOBS);
+  }
+  event_expiry_.start();
+  expiry_thread_ = std::thread(&TribuneClient::eventExpiryLoop, this);
+  tree_deadlines_.start();
+  tree_flush_thread_ = std::thread(&TribuneClient::treeFlushLoop, this);
   listener_thread_ = std::thread(&TribuneClient::runEventListener, this);
   health_checker_thread_ =
       std::thread(&TribuneClient::periodicHealthChecker, this);
@@ -221,7 +307,11 @@ void TribuneClient::startListening() {
 
 void TribuneClient::runEventListener() {
   DEBUG_INFO("Event listener thread started");
-  event_server_.listen("localhost", listen_port_);
+  bool ok = epoll_transport_ ? epoll_transport_->listen(listen_host_, listen_port_)
+                             : event_server_.listen(listen_host_, listen_port_);
+  if (!ok) {
+    DEBUG_ERROR("Failed to listen on " << listen_host_ << ":" << listen_port_);
+  }
 }
 
 void TribuneClient::onEventAnnouncement(const Event &event, bool relay) {
@@ -233,10 +323,7 @@ void TribuneClient::onEventAnnouncement(const Event &event, bool relay) {
   LOG("=======================");
 
   // Store event for validation and computation
-  {
-    std::unique_lock<std::shared_mutex> lock(active_events_mutex_);
-    active_events_[event.event_id] = event;
-  }
+  trackEvent(event);
 
   // Use data collection module to get client's data for this event
   std::string my_data;
@@ -304,31 +391,20 @@ void TribuneClient::onPeerDataReceived(const PeerDataMessage &peer_msg) {
     }
   }
 
-  // 2. TTL-based deduplication to prevent broadcast storms
-  std::string shard_key = peer_msg.event_id + "|" + peer_msg.from_client;
-
-  {
-    std::unique_lock<std::shared_mutex> lock(recent_items_mutex_);
-
-    // Only check for duplicate shards (allow shard processing even if we know
-    // the event)
-    if (recent_shards_.find(shard_key) != recent_shards_.end()) {
-      DEBUG_DEBUG("Ignoring duplicate shard: " << shard_key);
-      return;
-    }
-
-    // Mark shard as recently seen
-    recent_shards_[shard_key] = {now};
+  // 2. TTL-based deduplication to prevent broadcast storms. Only shards are
+  // deduplicated (allow shard processing even if we know the event)
+  if (!recent_shards_.insertIfAbsent(
+          RotatingDedupFilter::hashPair(peer_msg.event_id, peer_msg.from_client),
+          now)) {
+    DEBUG_DEBUG("Ignoring duplicate shard: " << peer_msg.event_id << "|"
+                                             << peer_msg.from_client);
+    return;
   }
 
   // 3. Process peer-propagated event if we don't know about it
-  bool have_event = false;
-  {
-    std::unique_lock<std::shared_mutex> active_lock(active_events_mutex_);
-    have_event = active_events_.find(peer_msg.event_id) != active_events_.end();
-  }
+  std::shared_ptr<ClientEvent> client_event = events_.find(peer_msg.event_id);
 
-  if (!have_event && !peer_msg.original_event.event_id.empty()) {
+  if (!client_event && !peer_msg.original_event.event_id.empty()) {
     DEBUG_DEBUG("Don't know about event "
                 << peer_msg.event_id << ", processing peer-propagated event");
 
@@ -338,7 +414,7 @@ void TribuneClient::onPeerDataReceived(const PeerDataMessage &peer_msg) {
     if (verifyEventFromServer(peer_msg.original_event)) {
       DEBUG_DEBUG("Valid server signature, processing peer event");
       onEventAnnouncement(peer_msg.original_event, false);
-      have_event = true; // Update flag since we now have the event
+      client_event = events_.find(peer_msg.event_id);
     } else {
       DEBUG_DEBUG("Invalid server signature on peer event, rejecting");
       return;
@@ -347,38 +423,20 @@ void TribuneClient::onPeerDataReceived(const PeerDataMessage &peer_msg) {
 
   // 3. Now process the shard data (we should know about the event at this
   // point)
-  if (!have_event) {
+  if (!client_event) {
     DEBUG_DEBUG("Still don't know about event " << peer_msg.event_id
                                                 << " after peer propagation");
     return;
   }
-
-  std::unique_lock<std::shared_mutex> active_lock(active_events_mutex_);
-  auto event_it = active_events_.find(peer_msg.event_id);
-  if (event_it == active_events_.end()) {
-    DEBUG_DEBUG("Event " << peer_msg.event_id << " not found in active events");
-    return;
-  }
+  const Event &event = client_event->event;
 
   // Check if sender is a valid participant
-  bool valid_participant = false;
-  std::string sender_public_key;
-
   DEBUG_DEBUG("Checking authorization for client " << peer_msg.from_client);
   DEBUG_DEBUG("Event " << peer_msg.event_id << " has "
-                       << event_it->second.participants.size()
-                       << " participants:");
-
-  for (const auto &participant : event_it->second.participants) {
-    DEBUG_DEBUG("- " << participant.client_id);
-    if (participant.client_id == peer_msg.from_client) {
-      valid_participant = true;
-      sender_public_key = participant.ed25519_pub;
-      break;
-    }
-  }
+                       << event.participants.size() << " participants");
 
-  if (!valid_participant) {
+  auto sender = client_event->participantIndex(peer_msg.from_client);
+  if (!sender) {
     DEBUG_DEBUG(
         "Rejected shard from unauthorized client: " << peer_msg.from_client);
     DEBUG_DEBUG("Client not found in participant list!");
@@ -391,7 +449,7 @@ void TribuneClient::onPeerDataReceived(const PeerDataMessage &peer_msg) {
   std::string message =
       peer_msg.event_id + "|" + peer_msg.from_client + "|" + peer_msg.data;
   bool signature_valid = SignatureUtils::verifySignature(
-      message, peer_msg.signature, sender_public_key);
+      message, peer_msg.signature, event.participants[*sender].ed25519_pub);
 
   if (!signature_valid) {
     DEBUG_DEBUG(
@@ -399,114 +457,93 @@ void TribuneClient::onPeerDataReceived(const PeerDataMessage &peer_msg) {
     return;
   }
 
-  // Store the valid shard
+  // Store the valid shard; only this event's lock is taken
   bool all_shards_received = false;
-  {
-    std::unique_lock<std::shared_mutex> shards_lock(event_shards_mutex_);
-    try {
-      // peer_msg.data is now a plain string number, not JSON
-      std::string shard_value = peer_msg.data;
-      event_shards_[peer_msg.event_id][peer_msg.from_client] = shard_value;
-      DEBUG_DEBUG("Stored valid shard from "
-                  << peer_msg.from_client << " (value: " << shard_value << ")");
-    } catch (const std::exception &e) {
-      DEBUG_DEBUG("Error processing peer data: " << e.what());
-      return;
-    }
-
-    all_shards_received = hasAllShards(peer_msg.event_id);
+  try {
+    all_shards_received = client_event->storeShard(*sender, peer_msg.data);
+    DEBUG_DEBUG("Stored valid shard from "
+                << peer_msg.from_client << " (value: " << peer_msg.data << ")");
+  } catch (const std::exception &e) {
+    DEBUG_DEBUG("Error processing peer data: " << e.what());
+    return;
   }
 
   // Start computation if we have all shards
   if (all_shards_received) {
-    // Check if computation is already in progress for this event
-    bool should_compute = false;
-    {
-      std::lock_guard<std::mutex> lock(computing_events_mutex_);
-      if (computing_events_.find(peer_msg.event_id) ==
-          computing_events_.end()) {
-        computing_events_.insert(peer_msg.event_id);
-        should_compute = true;
-      }
-    }
-
-    if (should_compute) {
-      DEBUG_DEBUG("All shards received for event " << peer_msg.event_id
-                                                   << ", starting computation");
-      std::thread([this, event_id = peer_msg.event_id]() {
-        computeAndSubmitResult(event_id);
-        // Remove from computing set after completion
-        {
-          std::lock_guard<std::mutex> lock(computing_events_mutex_);
-          computing_events_.erase(event_id);
-        }
-      }).detach();
-    } else {
-      DEBUG_DEBUG("Computation already in progress for event "
-                  << peer_msg.event_id);
-    }
-  }
-
-  // Periodic cleanup of deduplication caches
-  // Triggered every CLEANUP_FREQUENCY peer messages to avoid timer threads
-  if (++cleanup_counter_ % CLEANUP_FREQUENCY == 0) {
-    cleanupRecentItems();
+    DEBUG_DEBUG("All shards received for event " << peer_msg.event_id);
+    startComputation(std::move(client_event));
   }
 }
 
 void TribuneClient::shareDataWithPeers(const Event &event,
                                        const std::string &my_data) {
   DEBUG_INFO("Sharing data with peers for event: " << event.event_id);
+  std::shared_ptr<ClientEvent> client_event = events_.find(event.event_id);
+  if (!client_event) {
+    DEBUG_WARN("Not sharing data for untracked event: " << event.event_id);
+    return;
+  }
+  client_event->advance(EventPhase::Sharing);
+
+  if (!client_event->module) {
+    DEBUG_ERROR(
+        "No MPC module registered for type: " << event.computation_type);
+    return;
+  }
 
   // Calculate total number of shards needed (one per participant, INCLUDING
-  // ourselves)
+  // ourselves); each protocol says how many it needs to stay secure
   int num_participants = event.participants.size();
-  if (num_participants <= 3) {
-    DEBUG_WARN("Not enough peers to share data with to stat secure");
+  if (num_participants < client_event->module->getProtocolMetadata().min_participants) {
+    DEBUG_WARN("Not enough peers to share data with to stay secure");
     return;
   }
 
-  // Generate shards using the MPC module
-  std::vector<DataShard> data_shards;
-  std::vector<std::string> shards;  // Keep for compatibility with peer messaging
-  {
-    std::unique_lock<std::shared_mutex> lock(modules_mutex_);
-    auto mod_it = modules_.find(event.computation_type);
-    if (mod_it != modules_.end()) {
-      data_shards = mod_it->second->shardData(my_data, &event);
-      
-      // Apply masking to shards and convert to string for transmission
-      auto masked_shards = mod_it->second->maskShards(data_shards, &event, client_id_);
-      for (const auto& shard : masked_shards) {
-        shards.push_back(shard.data);
-      }
-      
-      DEBUG_INFO("Split data into " << data_shards.size() << " shards for "
-                                    << num_participants << " participants");
-    } else {
-      DEBUG_ERROR(
-          "No MPC module registered for type: " << event.computation_type);
-      return;
+  // Protocols without a shard exchange submit our masked input directly
+  if (client_event->module->submitsDirectly()) {
+    if (client_event->tryStartComputing()) {
+      std::thread([this, client_event, my_data]() {
+        submitMaskedInput(client_event, my_data);
+      }).detach();
     }
+    return;
   }
 
+  // Generate masked shards using the MPC module, straight into the strings
+  // that are transmitted
+  std::vector<std::string> shards;
+  // This runs on the event's announcement thread, so a module error must
+  // not escape it
+  try {
+    client_event->module->shardDataInto(std::as_bytes(std::span(my_data)),
+                                        &event, client_id_, shards);
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Sharding failed for event " << event.event_id << ": "
+                                             << e.what());
+    expireEvent(*client_event);
+    return;
+  }
+  DEBUG_INFO("Split data into " << shards.size() << " shards for "
+                                << num_participants << " participants");
+
   if (shards.size() != static_cast<size_t>(num_participants)) {
     DEBUG_ERROR("Shard count mismatch: expected " << num_participants << " got "
                                                   << shards.size());
+    expireEvent(*client_event);
     return;
   }
 
-  // Store our own shard (the first one)
-  {
-    std::unique_lock<std::shared_mutex> shards_lock(event_shards_mutex_);
-    event_shards_[event.event_id][client_id_] = shards[0];
-    DEBUG_DEBUG("Stored our own shard: " << shards[0]);
+  // Shard i belongs to participant i: threshold schemes evaluate it at that
+  // participant's point, so we keep the one at our own index
+  if (auto self = client_event->participantIndex(client_id_)) {
+    client_event->storeShard(*self, shards[*self]);
+    DEBUG_DEBUG("Stored our own shard: " << shards[*self]);
   }
 
-  // Send a different shard to each peer (starting from index 1, since we kept
-  // index 0)
-  int shard_index = 1; // Start from 1 since we kept shard[0] for ourselves
-  for (const auto &peer : event.participants) {
+  // Send each peer the shard at its index
+  for (size_t shard_index = 0; shard_index < event.participants.size();
+       shard_index++) {
+    const auto &peer = event.participants[shard_index];
     // Skip ourselves
     if (peer.client_id == client_id_) {
       continue;
@@ -523,8 +560,8 @@ void TribuneClient::shareDataWithPeers(const Event &event,
             PeerDataMessage peer_msg;
             peer_msg.event_id = event.event_id;
             peer_msg.from_client = client_id_;
-            peer_msg.data =
-                shards[shard_index]; // Send the specific shard for this peer
+            peer_msg.data = std::move(
+                shards[shard_index]); // Send the specific shard for this peer
             peer_msg.timestamp = std::chrono::system_clock::now();
             peer_msg.original_event =
                 event; // Include server-signed event for propagation
@@ -533,7 +570,7 @@ void TribuneClient::shareDataWithPeers(const Event &event,
                 "Creating peer message with event_id: " << peer_msg.event_id);
             DEBUG_DEBUG(
                 "Original event ID: " << peer_msg.original_event.event_id);
-            DEBUG_DEBUG("Sending shard value: " << shards[shard_index]);
+            DEBUG_DEBUG("Sending shard value: " << peer_msg.data);
 
             // Create signature
             std::string message = peer_msg.event_id + "|" +
@@ -564,160 +601,457 @@ void TribuneClient::shareDataWithPeers(const Event &event,
                   << shard_index << " to " << peer.client_id << " from "
                   << client_id_ << ": " << e.what());
     }
-
-    // Move to next shard for next peer
-    shard_index++;
   }
 
   // After sending all shards, check if we already have all shards needed for
   // computation
-  bool all_shards_received = false;
-  {
-    std::unique_lock<std::shared_mutex> shards_lock(event_shards_mutex_);
-    all_shards_received = hasAllShards(event.event_id);
+  if (client_event->hasAllShards()) {
+    DEBUG_DEBUG("All shards received for event " << event.event_id
+                                                 << " after sending our shards");
+    startComputation(std::move(client_event));
   }
+}
 
-  // Start computation if we have all shards
-  if (all_shards_received) {
-    // Check if computation is already in progress for this event
-    bool should_compute = false;
-    {
-      std::lock_guard<std::mutex> lock(computing_events_mutex_);
-      if (computing_events_.find(event.event_id) == computing_events_.end()) {
-        computing_events_.insert(event.event_id);
-        should_compute = true;
-      }
-    }
+void TribuneClient::startComputation(std::shared_ptr<ClientEvent> client_event) {
+  // Check if computation is already in progress for this event
+  if (!client_event->tryStartComputing()) {
+    DEBUG_DEBUG("Computation already in progress for event "
+                << client_event->event.event_id);
+    return;
+  }
 
-    if (should_compute) {
-      DEBUG_DEBUG("All shards received for event "
-                  << event.event_id
-                  << " after sending our shards, starting computation");
-      std::thread([this, event_id = event.event_id]() {
-        computeAndSubmitResult(event_id);
-        // Remove from computing set after completion
-        {
-          std::lock_guard<std::mutex> lock(computing_events_mutex_);
-          computing_events_.erase(event_id);
-        }
-      }).detach();
-    } else {
-      DEBUG_DEBUG("Computation already in progress for event "
-                  << event.event_id);
-    }
+  DEBUG_DEBUG("Starting computation for event " << client_event->event.event_id);
+  std::thread([this, client_event = std::move(client_event)]() {
+    computeAndSubmitResult(client_event);
+  }).detach();
+}
+
+void TribuneClient::computeAndSubmitResult(
+    std::shared_ptr<ClientEvent> client_event) {
+  const Event &event = client_event->event;
+  LOG("=== COMPUTING RESULT FOR EVENT: " << event.event_id << " ===");
+  client_event->advance(EventPhase::Computing);
+
+  // Run the computation; the shards are not needed after this
+  std::string result = runComputation(*client_event);
+  client_event->releaseShards();
+
+  if (result.empty()) {
+    DEBUG_ERROR("Computation failed for event: " << event.event_id);
+    expireEvent(*client_event);
+    return;
   }
+  submitPartial(*client_event, result);
 }
 
-bool TribuneClient::hasAllShards(const std::string &event_id) {
-  // Must be called with active_events_mutex_ and event_shards_mutex_ held
-  auto event_it = active_events_.find(event_id);
-  if (event_it == active_events_.end()) {
-    return false;
+void TribuneClient::submitMaskedInput(std::shared_ptr<ClientEvent> client_event,
+                                      const std::string &my_data) {
+  const Event &event = client_event->event;
+  LOG("=== MASKING INPUT FOR EVENT: " << event.event_id << " ===");
+  client_event->advance(EventPhase::Computing);
+  client_event->releaseShards(); // No shards are exchanged
+
+  std::vector<std::string> masked;
+  try {
+    client_event->module->shardDataInto(std::as_bytes(std::span(my_data)), &event,
+                                        client_id_, masked);
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Masking failed for event " << event.event_id << ": " << e.what());
+    expireEvent(*client_event);
+    return;
   }
+  if (masked.size() != 1) {
+    DEBUG_ERROR("Masking failed for event: " << event.event_id);
+    expireEvent(*client_event);
+    return;
+  }
+  submitPartial(*client_event, masked[0]);
+}
 
-  auto shards_it = event_shards_.find(event_id);
-  if (shards_it == event_shards_.end()) {
-    return false;
+void TribuneClient::submitPartial(ClientEvent &client_event,
+                                  const std::string &result) {
+  const Event &event = client_event.event;
+
+  // In an aggregation tree our partial goes up the tree with our children's
+  if (AggregationTree::of(event)) {
+    TreePartial own{client_id_, nlohmann::json::parse(result), {client_id_}};
+    addTreePartials(client_event, client_id_, {std::move(own)});
+    client_event.advance(EventPhase::Submitted);
+    return;
   }
 
-  const Event &event = event_it->second;
-  const auto &received_shards = shards_it->second;
+  // Submit the result
+  if (!submitResult(event, result)) {
+    DEBUG_ERROR("Failed to submit result for event: " << event.event_id);
+    expireEvent(client_event);
+    return;
+  }
+  client_event.advance(EventPhase::Submitted);
+}
 
-  // Check if we have shards from all participants (including ourselves)
-  for (const auto &participant : event.participants) {
-    if (received_shards.find(participant.client_id) == received_shards.end()) {
-      return false;
-    }
+std::string TribuneClient::runComputation(ClientEvent &client_event) {
+  const Event &event = client_event.event;
+
+  // The module reads the shards where they were received, in participant
+  // order; nothing is copied or allocated to set up the computation
+  std::span<const ShardView> shards = client_event.freezeShards();
+  if (shards.empty()) {
+    DEBUG_ERROR("Error: Shards not found for " << event.event_id);
+    return "";
   }
 
-  return true;
+  // Execute the computation with the module bound when the event arrived
+  if (!client_event.module) {
+    DEBUG_ERROR(
+        "Error: No module registered for type: " << event.computation_type);
+    return "";
+  }
+  std::string result;
+  try {
+    client_event.module->computePartialInto(&event, shards, result);
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Computation failed for event " << event.event_id << ": "
+                                                << e.what());
+    return "";
+  }
+
+  LOG("Computation complete! Result: " << result);
+  return result;
 }
 
-void TribuneClient::computeAndSubmitResult(const std::string &event_id) {
-  LOG("=== COMPUTING RESULT FOR EVENT: " << event_id << " ===");
+int TribuneClient::verifyTreePartial(const TreePartialMessage &msg,
+                                     std::shared_ptr<ClientEvent> &client_event) {
+  client_event = events_.find(msg.event_id);
+  if (!client_event) {
+    DEBUG_WARN("Tree partial for unknown event " << msg.event_id);
+    return 404;
+  }
+  const Event &event = client_event->event;
+
+  auto tree = AggregationTree::of(event);
+  auto sender = client_event->participantIndex(msg.from_client);
+  auto self = client_event->participantIndex(client_id_);
+  if (!tree || !sender || !self || tree->parentOf(*sender) != *self) {
+    DEBUG_WARN("Rejected tree partial from " << msg.from_client
+               << ": not our child in event " << msg.event_id);
+    return 403;
+  }
 
-  // Run the computation
-  std::string result = runComputation(event_id);
+  std::string message = msg.event_id + "|" + msg.from_client + "|" +
+                        nlohmann::json(msg.bundle).dump();
+  if (!SignatureUtils::verifySignature(message, msg.signature,
+                                       event.participants[*sender].ed25519_pub)) {
+    DEBUG_WARN("Rejected tree partial with invalid signature from: "
+               << msg.from_client);
+    return 403;
+  }
+  return 200;
+}
 
-  if (result.empty()) {
-    DEBUG_ERROR("Computation failed for event: " << event_id);
+void TribuneClient::addTreePartials(const ClientEvent &client_event,
+                                    const std::string &from_client,
+                                    std::vector<TreePartial> partials) {
+  const Event &event = client_event.event;
+  auto tree = AggregationTree::of(event);
+  auto self = client_event.participantIndex(client_id_);
+  if (!tree || !self) {
     return;
   }
 
-  // Submit the result
-  if (!submitResult(event_id, result)) {
-    DEBUG_ERROR("Failed to submit result for event: " << event_id);
+  auto now = std::chrono::system_clock::now();
+  std::vector<TreePartial> ready;
+  bool forward_now = false;
+  bool start_timer = false;
+  std::chrono::system_clock::time_point deadline;
+  {
+    std::lock_guard<std::mutex> lock(tree_aggregations_mutex_);
+    auto [agg_it, inserted] = tree_aggregations_.try_emplace(event.event_id);
+    TreeAggregation &agg = agg_it->second;
+    if (inserted) {
+      agg.children_pending = tree->childrenOf(*self).size();
+      agg.deadline = event.timestamp + tree->forwardDeadline(*self);
+      start_timer = agg.deadline > now;
+    }
+    deadline = agg.deadline;
+
+    if (agg.forwarded) {
+      DEBUG_WARN("Dropping late tree partial from " << from_client
+                 << " for event " << event.event_id);
+      return;
+    }
+    if (from_client == client_id_) {
+      if (agg.own_partial) {
+        return;
+      }
+      agg.own_partial = true;
+    } else {
+      if (!agg.reported_children.insert(from_client).second) {
+        return; // Duplicate delivery
+      }
+      agg.children_pending--;
+    }
+    std::move(partials.begin(), partials.end(), std::back_inserter(agg.bundle));
+
+    // Forward once the whole subtree reported, or immediately if the
+    // deadline already passed (the timer has fired, or never will)
+    if ((agg.own_partial && agg.children_pending == 0) || now >= agg.deadline) {
+      agg.forwarded = true;
+      ready = std::move(agg.bundle);
+      forward_now = true;
+      if (now >= agg.deadline) {
+        tree_aggregations_.erase(agg_it);
+      }
+    }
+  }
+
+  if (start_timer) {
+    // Forward whatever has arrived by the deadline, so a slow or failed
+    // child costs its subtree rather than ours. The deadline is wall-clock
+    // (the event's timestamp); the queue runs on the steady clock.
+    tree_deadlines_.schedule(
+        event.event_id,
+        std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(deadline - now));
+  }
+
+  if (forward_now) {
+    forwardTreePartials(client_event, std::move(ready));
   }
 }
 
-std::string TribuneClient::runComputation(const std::string &event_id) {
-  Event event;
-  std::vector<std::string> shards;
-  std::string computation_type;
+void TribuneClient::treeFlushLoop() {
+  DEBUG_INFO("Started tree flush thread");
+  while (running_) {
+    // Aggregations already forwarded or evicted are skipped by the flush
+    for (const std::string &event_id : tree_deadlines_.waitExpired()) {
+      flushTreePartials(event_id);
+    }
+  }
+  DEBUG_INFO("Stopped tree flush thread");
+}
 
-  // Collect event info and shards
+void TribuneClient::flushTreePartials(const std::string &event_id) {
+  std::vector<TreePartial> ready;
+  bool forward_now = false;
   {
-    std::shared_lock<std::shared_mutex> active_lock(active_events_mutex_);
-    std::shared_lock<std::shared_mutex> shards_lock(event_shards_mutex_);
+    std::lock_guard<std::mutex> lock(tree_aggregations_mutex_);
+    auto agg_it = tree_aggregations_.find(event_id);
+    if (agg_it == tree_aggregations_.end()) {
+      return;
+    }
+    if (!agg_it->second.forwarded) {
+      DEBUG_WARN("Tree deadline for event " << event_id << ": forwarding with "
+                 << agg_it->second.children_pending << " children missing"
+                 << (agg_it->second.own_partial ? "" : " and no own partial"));
+      ready = std::move(agg_it->second.bundle);
+      forward_now = true;
+    }
+    tree_aggregations_.erase(agg_it);
+  }
 
-    auto event_it = active_events_.find(event_id);
-    auto shards_it = event_shards_.find(event_id);
+  if (forward_now) {
+    if (auto client_event = events_.find(event_id)) {
+      forwardTreePartials(*client_event, std::move(ready));
+    }
+  }
+}
 
-    if (event_it == active_events_.end() || shards_it == event_shards_.end()) {
-      DEBUG_ERROR("Error: Event or shards not found for " << event_id);
-      return "";
+void TribuneClient::forwardTreePartials(const ClientEvent &client_event,
+                                        std::vector<TreePartial> bundle) {
+  const Event &event = client_event.event;
+  if (bundle.empty()) {
+    return;
+  }
+
+  // Modules with an associative aggregate collapse the subtree into one
+  // partial; otherwise the entries travel up individually
+  if (bundle.size() > 1) {
+    if (client_event.module) {
+      std::vector<PartialResult> partials;
+      partials.reserve(bundle.size());
+      for (const auto &entry : bundle) {
+        PartialResult partial;
+        partial.participant_id = entry.participant_id;
+        partial.value = entry.value;
+        partials.push_back(std::move(partial));
+      }
+      if (auto combined = client_event.module->combinePartials(partials, &event)) {
+        TreePartial merged{client_id_, std::move(combined->value), {}};
+        for (auto &entry : bundle) {
+          std::move(entry.contributors.begin(), entry.contributors.end(),
+                    std::back_inserter(merged.contributors));
+        }
+        bundle.clear();
+        bundle.push_back(std::move(merged));
+      }
+    }
+  }
+
+  auto tree = AggregationTree::of(event);
+  auto self = client_event.participantIndex(client_id_);
+  if (!tree || !self) {
+    return;
+  }
+  size_t parent = tree->parentOf(*self);
+
+  if (parent == AggregationTree::SERVER) {
+    if (!submitResult(event, nlohmann::json(bundle).dump())) {
+      DEBUG_ERROR("Failed to submit tree bundle for event: " << event.event_id);
     }
+    return;
+  }
 
-    event = event_it->second;
-    computation_type = event.computation_type;
+  TreePartialMessage msg;
+  msg.event_id = event.event_id;
+  msg.from_client = client_id_;
+  msg.bundle = std::move(bundle);
+  std::string message = msg.event_id + "|" + msg.from_client + "|" +
+                        nlohmann::json(msg.bundle).dump();
+  msg.signature = SignatureUtils::createSignature(message, ed25519_private_key_);
+  nlohmann::json payload = msg;
 
-    // Collect shards in participant order for consistency
-    for (const auto &participant : event.participants) {
-      auto shard_it = shards_it->second.find(participant.client_id);
-      if (shard_it != shards_it->second.end()) {
-        shards.push_back(shard_it->second);
+  const ClientInfo &peer = event.participants[parent];
+  try {
+    auto res = connection_pool_.withConnection(
+        peer.client_host, std::stoi(peer.client_port), [&](auto *client) {
+          return client->Post("/partial", payload.dump(), "application/json");
+        });
+    if (res && res->status == 200) {
+      DEBUG_DEBUG("Forwarded tree bundle for event " << event.event_id
+                  << " to " << peer.client_id);
+    } else {
+      DEBUG_ERROR("Failed to forward tree bundle for event "
+                  << event.event_id << " to " << peer.client_id << " (status: "
+                  << (res ? std::to_string(res->status) : "no response") << ")");
+    }
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Exception forwarding tree bundle to " << peer.client_id
+                << ": " << e.what());
+  }
+}
+
+std::shared_ptr<ClientEvent> TribuneClient::trackEvent(const Event &event) {
+  auto expires = std::chrono::steady_clock::now() +
+                 std::chrono::seconds(config_.event_retention_seconds);
+  auto [client_event, inserted] = events_.findOrInsert(event.event_id, [&]() {
+    return std::make_shared<ClientEvent>(event, modules_.find(event.computation_type),
+                                         expires);
+  });
+  if (!inserted) {
+    return client_event; // Re-announced (e.g. relayed by a peer); keep its progress
+  }
+  event_expiry_.schedule(event.event_id, expires);
+
+  // Over capacity: make room by dropping the oldest finished event, or
+  // failing that the oldest one not being computed
+  if (events_.size() > static_cast<size_t>(config_.max_retained_events)) {
+    std::string victim;
+    bool victim_done = false;
+    ClientEvent::Clock::time_point victim_expires;
+    events_.forEach([&](const std::string &event_id,
+                        const std::shared_ptr<ClientEvent> &candidate) {
+      EventPhase phase = candidate->phase();
+      if (candidate == client_event || phase == EventPhase::Computing) {
+        return;
+      }
+      bool done = phase == EventPhase::Submitted;
+      auto candidate_expires = candidate->expires();
+      if (victim.empty() ||
+          (done != victim_done ? done : candidate_expires < victim_expires)) {
+        victim = event_id;
+        victim_done = done;
+        victim_expires = candidate_expires;
       }
+    });
+    if (!victim.empty() && evictEvent(victim, false)) {
+      events_evicted_++;
+      DEBUG_DEBUG("Evicted event " << victim << " to stay within "
+                  << config_.max_retained_events << " retained events");
     }
   }
+  return client_event;
+}
 
-  // Find and execute computation
-  std::string result;
+void TribuneClient::expireEvent(ClientEvent &client_event) {
+  auto now = std::chrono::steady_clock::now();
+  client_event.expireNow(now);
+  event_expiry_.schedule(client_event.event.event_id, now);
+}
+
+bool TribuneClient::evictEvent(const std::string &event_id, bool at_deadline) {
+  auto now = std::chrono::steady_clock::now();
+  std::shared_ptr<ClientEvent> client_event = events_.find(event_id);
+  if (!client_event) {
+    return false;
+  }
+  if (at_deadline && client_event->expires() > now) {
+    return false; // Stale queue entry
+  }
+  if (client_event->phase() == EventPhase::Computing) {
+    // Still being worked on; look again later
+    auto expires = now + std::chrono::seconds(EVENT_TIMEOUT_SECONDS);
+    client_event->setExpires(expires);
+    event_expiry_.schedule(event_id, expires);
+    return false;
+  }
+  if (!events_.eraseIf(event_id, client_event)) {
+    return false; // Replaced by a newer announcement meanwhile
+  }
   {
-    std::shared_lock<std::shared_mutex> mod_lock(modules_mutex_);
-    auto mod_it = modules_.find(computation_type);
+    std::lock_guard<std::mutex> lock(tree_aggregations_mutex_);
+    tree_aggregations_.erase(event_id);
+  }
+  // Threads still holding the event keep it alive; otherwise it is freed
+  // here, outside every lock
+  return true;
+}
 
-    if (mod_it == modules_.end()) {
-      DEBUG_ERROR(
-          "Error: No module registered for type: " << computation_type);
-      return "";
+void TribuneClient::eventExpiryLoop() {
+  DEBUG_INFO("Started event expiry thread");
+  while (running_) {
+    size_t expired = 0;
+    for (const std::string &event_id : event_expiry_.waitExpired()) {
+      if (evictEvent(event_id, true)) {
+        expired++;
+      }
     }
-
-    // Convert collected shards to DataShard objects for computation
-    std::vector<DataShard> collected_shards;
-    for (size_t i = 0; i < shards.size(); i++) {
-      DataShard shard;
-      shard.participant_id = "participant_" + std::to_string(i);  // Could be improved with actual IDs
-      shard.data = shards[i];
-      shard.shard_index = i;
-      collected_shards.push_back(shard);
+    if (expired > 0) {
+      events_expired_ += expired;
+      DEBUG_DEBUG("Expired " << expired << " events");
     }
-    
-    PartialResult partial = mod_it->second->computePartial(&event, collected_shards);
-    result = partial.value.dump();  // Convert JSON result to string
   }
+  DEBUG_INFO("Stopped event expiry thread");
+}
 
-  LOG("Computation complete! Result: " << result);
-  return result;
+ClientEventStats TribuneClient::getEventStats() {
+  ClientEventStats stats;
+  events_.forEach([&](const std::string &,
+                      const std::shared_ptr<ClientEvent> &client_event) {
+    stats.retained_events++;
+    stats.events_by_phase[static_cast<size_t>(client_event->phase())]++;
+    stats.event_bytes += client_event->event_bytes;
+    stats.arena_bytes += client_event->arenaBytes();
+  });
+  stats.expired_total = events_expired_;
+  stats.evicted_over_capacity = events_evicted_;
+  return stats;
 }
 
-bool TribuneClient::submitResult(const std::string &event_id,
-                                 const std::string &result) {
+bool TribuneClient::submitResult(const Event &event, const std::string &result) {
   try {
-    httplib::Client cli(seed_host_, seed_port_);
+    // Sharded coordinators name the shard that aggregates this event
+    std::string host = seed_host_;
+    int port = seed_port_;
+    if (!event.aggregator.empty()) {
+      size_t colon = event.aggregator.rfind(':');
+      host = event.aggregator.substr(0, colon);
+      port = std::stoi(event.aggregator.substr(colon + 1));
+    }
+    httplib::Client cli(host, port);
 
     EventResponse response;
     response.type_ = ResponseType::DataPart;
-    response.event_id = event_id;
+    response.event_id = event.event_id;
     response.client_id = client_id_;
     response.data = result;
     response.timestamp = std::chrono::system_clock::now();
@@ -729,6 +1063,21 @@ bool TribuneClient::submitResult(const std::string &event_id,
     DEBUG_INFO("Sending computation result to server...");
     auto res = cli.Post("/submit", json_body, "application/json");
 
+    // The server sheds load with 503 during submit bursts; honor Retry-After
+    static constexpr int MAX_SUBMIT_RETRIES = 3;
+    for (int attempt = 0;
+         attempt < MAX_SUBMIT_RETRIES && res && res->status == 503; attempt++) {
+      int retry_after = 1;
+      try {
+        retry_after = std::clamp(std::stoi(res->get_header_value("Retry-After")),
+                                 1, EVENT_TIMEOUT_SECONDS);
+      } catch (const std::exception &) {
+      }
+      DEBUG_WARN("Server busy, retrying submit in " << retry_after << "s");
+      std::this_thread::sleep_for(std::chrono::seconds(retry_after));
+      res = cli.Post("/submit", json_body, "application/json");
+    }
+
     if (res && res->status == 200) {
       DEBUG_INFO("Successfully sent result to server!");
       DEBUG_DEBUG("Server response: " << res->body);
@@ -751,7 +1100,14 @@ bool TribuneClient::submitResult(const std::string &event_id,
 void TribuneClient::stop() {
   if (running_) {
     running_ = false;
-    event_server_.stop();
+    if (epoll_transport_) {
+      epoll_transport_->stop();
+    } else {
+      event_server_.stop();
+    }
+    if (epoll_workers_) {
+      epoll_workers_->shutdown(); // Runs the handlers already accepted
+    }
 
     if (listener_thread_.joinable()) {
       listener_thread_.join();
@@ -759,6 +1115,14 @@ void TribuneClient::stop() {
     if (health_checker_thread_.joinable()) {
       health_checker_thread_.join();
     }
+    event_expiry_.stop();
+    if (expiry_thread_.joinable()) {
+      expiry_thread_.join();
+    }
+    tree_deadlines_.stop();
+    if (tree_flush_thread_.joinable()) {
+      tree_flush_thread_.join();
+    }
 
     LOG("Client stopped");
   }
@@ -815,41 +1179,9 @@ void TribuneClient::periodicHealthChecker() {
   DEBUG_INFO("Stopped health checker thread");
 }
 
-void TribuneClient::cleanupRecentItems() {
-  std::unique_lock<std::shared_mutex> lock(recent_items_mutex_);
-  auto now = std::chrono::steady_clock::now();
-
-  // Clean expired events
-  for (auto it = recent_events_.begin(); it != recent_events_.end();) {
-    auto age = std::chrono::duration_cast<std::chrono::seconds>(
-                   now - it->second.received_time)
-                   .count();
-
-    if (age > RECENT_ITEMS_TTL_SECONDS) {
-      it = recent_events_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-
-  // Clean expired shards
-  for (auto it = recent_shards_.begin(); it != recent_shards_.end();) {
-    auto age = std::chrono::duration_cast<std::chrono::seconds>(
-                   now - it->second.received_time)
-                   .count();
-
-    if (age > RECENT_ITEMS_TTL_SECONDS) {
-      it = recent_shards_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-}
-
 bool TribuneClient::verifyEventFromServer(const Event &event) {
   // Create the same hash that the server would have created
-  std::string event_hash = event.event_id + "|" + event.computation_type + "|" +
-                           std::to_string(event.participants.size());
+  std::string event_hash = eventSignaturePayload(event);
 
   DEBUG_DEBUG("CLIENT: Verifying event signature");
   DEBUG_DEBUG("CLIENT: Event hash: " << event_hash);
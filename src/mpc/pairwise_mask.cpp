@@ -0,0 +1,220 @@
+#include "mpc/pairwise_mask.hpp"
+#include "mpc/field_vector.hpp"
+#include "mpc/fixed_point.hpp"
+#include <sodium.h>
+#include <stdexcept>
+
+namespace {
+
+std::vector<uint64_t> decodeValues(const nlohmann::json &j) {
+  if (j.is_array()) {
+    return j.get<std::vector<uint64_t>>();
+  }
+  return {j.get<uint64_t>()};
+}
+
+std::vector<unsigned char> hexBytes(const std::string &hex, size_t bytes) {
+  std::vector<unsigned char> bin(bytes);
+  size_t bin_len = 0;
+  if (hex.size() != bytes * 2 ||
+      sodium_hex2bin(bin.data(), bin.size(), hex.data(), hex.size(), nullptr,
+                     &bin_len, nullptr) != 0 ||
+      bin_len != bytes) {
+    throw std::runtime_error("Invalid key length");
+  }
+  return bin;
+}
+
+// Input values in Z/2^64, fixed-point encoded when the event asks for it
+std::vector<uint64_t> inputValues(const nlohmann::json &input, const Event &event) {
+  if (auto codec = FixedPointCodec::fromEvent(event)) {
+    return codec->encodeJson(input);
+  }
+  return decodeValues(input);
+}
+
+std::vector<uint64_t> sumPartials(const std::vector<PartialResult> &partials) {
+  return FieldVector<uint64_t>::sumOf(
+      partials, [](const PartialResult &partial) { return decodeValues(partial.value); });
+}
+
+} // namespace
+
+PairwiseMaskSum::PairwiseMaskSum(const std::string &private_key) {
+  if (sodium_init() < 0) {
+    throw std::runtime_error("Failed to initialize libsodium");
+  }
+  if (!private_key.empty()) {
+    std::vector<unsigned char> sk = hexBytes(private_key, crypto_sign_SECRETKEYBYTES);
+    crypto_sign_ed25519_sk_to_pk(ed25519_pk_.data(), sk.data());
+    crypto_sign_ed25519_sk_to_curve25519(x25519_sk_.data(), sk.data());
+    sodium_memzero(sk.data(), sk.size());
+    has_key_ = true;
+  }
+}
+
+PairwiseMaskSum::~PairwiseMaskSum() {
+  sodium_memzero(x25519_sk_.data(), x25519_sk_.size());
+}
+
+ProtocolMetadata PairwiseMaskSum::getProtocolMetadata() const {
+  return ProtocolMetadata{"pairwise_mask_sum", 2, 0, false,
+                          nlohmann::json{{"key_exchange", "x25519"},
+                                         {"prg", "chacha20"}}};
+}
+
+std::vector<DataShard> PairwiseMaskSum::shardData(const std::string &raw_data,
+                                                  const Event *event) {
+  std::vector<DataShard> shards;
+  shards.push_back(DataShard{"", nlohmann::json(inputValues(nlohmann::json::parse(raw_data), *event)).dump(),
+                             0, nlohmann::json::object()});
+  return shards;
+}
+
+std::vector<DataShard>
+PairwiseMaskSum::maskShards(const std::vector<DataShard> &shards, const Event *event,
+                            const std::string &participant_id) {
+  std::vector<DataShard> masked = shards;
+  for (auto &shard : masked) {
+    std::vector<uint64_t> values = decodeValues(nlohmann::json::parse(shard.data));
+    applyMasks(values, *event, participant_id);
+    shard.participant_id = participant_id;
+    shard.data = nlohmann::json(values).dump();
+  }
+  return masked;
+}
+
+void PairwiseMaskSum::shardDataInto(std::span<const std::byte> raw_data,
+                                    const Event *event,
+                                    const std::string &participant_id,
+                                    std::vector<std::string> &out) {
+  const char *begin = reinterpret_cast<const char *>(raw_data.data());
+  std::vector<uint64_t> values =
+      inputValues(nlohmann::json::parse(begin, begin + raw_data.size()), *event);
+  applyMasks(values, *event, participant_id);
+  out.resize(1);
+  out[0] = nlohmann::json(values).dump();
+}
+
+void PairwiseMaskSum::applyMasks(std::vector<uint64_t> &values, const Event &event,
+                                 const std::string &participant_id) const {
+  if (!has_key_) {
+    throw std::runtime_error("Pairwise masking needs the client's private key");
+  }
+
+  size_t self = event.participants.size();
+  for (size_t i = 0; i < event.participants.size(); i++) {
+    if (event.participants[i].client_id == participant_id) {
+      self = i;
+      break;
+    }
+  }
+  if (self == event.participants.size()) {
+    throw std::runtime_error("Not a participant of event " + event.event_id);
+  }
+  // Peers derive our masks from the key the server lists for us; any other
+  // key leaves masks that never cancel
+  std::vector<unsigned char> listed_pk =
+      hexBytes(event.participants[self].ed25519_pub, crypto_sign_PUBLICKEYBYTES);
+  if (sodium_memcmp(listed_pk.data(), ed25519_pk_.data(), ed25519_pk_.size()) != 0) {
+    throw std::runtime_error("Pairwise mask key is not " + participant_id +
+                             "'s registered key");
+  }
+
+  // One keystream buffer, reused for every peer
+  std::vector<unsigned char> stream(values.size() * sizeof(uint64_t));
+  const unsigned char nonce[crypto_stream_chacha20_NONCEBYTES] = {0};
+
+  for (size_t peer = 0; peer < event.participants.size(); peer++) {
+    if (peer == self) {
+      continue;
+    }
+
+    // Both ends of the pair compute the same X25519 secret. Hashing in the
+    // server's signature over the event, which covers its ID and timestamp,
+    // gives each event fresh masks even if an ID is reused, so one nonce
+    // suffices.
+    std::vector<unsigned char> peer_ed =
+        hexBytes(event.participants[peer].ed25519_pub, crypto_sign_PUBLICKEYBYTES);
+    std::array<unsigned char, 32> peer_pk{};
+    if (crypto_sign_ed25519_pk_to_curve25519(peer_pk.data(), peer_ed.data()) != 0) {
+      throw std::runtime_error("Invalid Ed25519 public key");
+    }
+    unsigned char shared[crypto_scalarmult_BYTES];
+    if (crypto_scalarmult(shared, x25519_sk_.data(), peer_pk.data()) != 0) {
+      throw std::runtime_error("Key exchange failed with " +
+                               event.participants[peer].client_id);
+    }
+    unsigned char seed[crypto_stream_chacha20_KEYBYTES];
+    crypto_generichash_state state;
+    crypto_generichash_init(&state, nullptr, 0, sizeof(seed));
+    crypto_generichash_update(&state, shared, sizeof(shared));
+    crypto_generichash_update(
+        &state, reinterpret_cast<const unsigned char *>(event.event_id.data()),
+        event.event_id.size());
+    crypto_generichash_update(
+        &state, reinterpret_cast<const unsigned char *>(event.server_signature.data()),
+        event.server_signature.size());
+    crypto_generichash_final(&state, seed, sizeof(seed));
+    sodium_memzero(shared, sizeof(shared));
+
+    crypto_stream_chacha20(stream.data(), stream.size(), nonce, seed);
+    sodium_memzero(seed, sizeof(seed));
+
+    // Masks are read little-endian so every platform derives the same ones
+    bool add = self < peer;
+    for (size_t j = 0; j < values.size(); j++) {
+      const unsigned char *p = stream.data() + j * sizeof(uint64_t);
+      uint64_t mask = 0;
+      for (size_t b = 0; b < sizeof(uint64_t); b++) {
+        mask |= uint64_t{p[b]} << (8 * b);
+      }
+      values[j] = add ? values[j] + mask : values[j] - mask;
+    }
+  }
+  sodium_memzero(stream.data(), stream.size());
+}
+
+PartialResult
+PairwiseMaskSum::computePartial(const Event *event,
+                                const std::vector<DataShard> &collected_shards) {
+  // Only the client's own masked shard exists, so this passes it through
+  PartialResult partial;
+  partial.value = FieldVector<uint64_t>::sumOf(collected_shards, [](const DataShard &shard) {
+    return decodeValues(nlohmann::json::parse(shard.data));
+  });
+  return partial;
+}
+
+PartialResult PairwiseMaskSum::computePartialViews(const Event *event,
+                                                   std::span<const ShardView> shards) {
+  PartialResult partial;
+  partial.value = FieldVector<uint64_t>::sumOf(shards, [](const ShardView &shard) {
+    return decodeValues(nlohmann::json::parse(shard.data));
+  });
+  return partial;
+}
+
+FinalResult PairwiseMaskSum::aggregate(const std::vector<PartialResult> &partials,
+                                       const Event *event) {
+  // Threshold 0 makes the server wait for every participant, which the
+  // masks need to cancel
+  FinalResult result;
+  std::vector<uint64_t> sum = sumPartials(partials);
+  auto codec = event ? FixedPointCodec::fromEvent(*event) : std::nullopt;
+  if (codec) {
+    result.value = codec->decodeJson(sum, event->participants.size());
+  } else {
+    result.value = sum;
+  }
+  result.verified = true;
+  return result;
+}
+
+std::optional<PartialResult>
+PairwiseMaskSum::combinePartials(const std::vector<PartialResult> &partials,
+                                 const Event *event) {
+  PartialResult partial;
+  partial.value = sumPartials(partials);
+  return partial;
+}
@@ -1,4 +1,5 @@
 #include "server/client_state.hpp"
+#include <algorithm>
 
 bool ClientState::isAlive(int timeout_seconds) const {
     auto now = std::chrono::steady_clock::now();
@@ -8,4 +9,29 @@ bool ClientState::isAlive(int timeout_seconds) const {
 
 void ClientState::updatePingTime() {
     last_ping_time_ = std::chrono::steady_clock::now();
-}
\ No newline at end of file
+}
+
+void ClientState::recordResponseLatency(double latency_ms) {
+    constexpr double alpha = 0.2;
+    if (avg_response_ms_ == 0.0) {
+        avg_response_ms_ = latency_ms;
+    } else {
+        avg_response_ms_ = alpha * latency_ms + (1.0 - alpha) * avg_response_ms_;
+    }
+}
+
+void ClientState::recordParticipation(bool responded) {
+    events_assigned_++;
+    if (responded) {
+        events_completed_++;
+    }
+}
+
+double ClientState::selectionWeight() const {
+    // Laplace-smoothed success rate, so new clients start at 0.5
+    double success_rate = (events_completed_ + 1.0) / (events_assigned_ + 2.0);
+    // Divide by 1 + average response latency in seconds: 1/2 at 1 s, 1/3 at
+    // 2 s, so slow clients fade gradually rather than exponentially
+    double latency_factor = 1.0 / (1.0 + avg_response_ms_ / 1000.0);
+    return std::max(success_rate * latency_factor, 1e-6);
+}
@@ -0,0 +1,47 @@
+#include "server/hash_ring.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+uint64_t HashRing::hash(std::string_view data) {
+    // FNV-1a, then a splitmix64 finalizer so similar addresses spread out
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (unsigned char c : data) {
+        h ^= c;
+        h *= 0x100000001b3ULL;
+    }
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+void HashRing::addNode(const std::string &node) {
+    if (contains(node)) {
+        return;
+    }
+    size_t index = nodes_.size();
+    nodes_.push_back(node);
+    for (size_t i = 0; i < virtual_nodes_; i++) {
+        points_.emplace_back(hash(node + "#" + std::to_string(i)), index);
+    }
+    std::sort(points_.begin(), points_.end());
+}
+
+bool HashRing::contains(const std::string &node) const {
+    return std::find(nodes_.begin(), nodes_.end(), node) != nodes_.end();
+}
+
+const std::string &HashRing::ownerOf(std::string_view key) const {
+    if (points_.empty()) {
+        throw std::logic_error("HashRing::ownerOf called on an empty ring");
+    }
+    uint64_t h = hash(key);
+    auto it = std::lower_bound(points_.begin(), points_.end(),
+                               std::make_pair(h, size_t{0}));
+    if (it == points_.end()) {
+        it = points_.begin(); // Wrap around
+    }
+    return nodes_[it->second];
+}
@@ -0,0 +1,33 @@
+#include "server/roster.hpp"
+
+ClientState &Roster::upsert(ClientState state) {
+    auto it = clients_.find(state.client_id_);
+    if (it != clients_.end()) {
+        size_t slot = it->second.roster_slot_;
+        it->second = std::move(state);
+        it->second.roster_slot_ = slot;
+        return it->second;
+    }
+
+    std::string client_id = state.client_id_;
+    auto [inserted, _] = clients_.emplace(std::move(client_id), std::move(state));
+    inserted->second.roster_slot_ = slots_.size();
+    slots_.push_back(&inserted->second);
+    return inserted->second;
+}
+
+bool Roster::erase(const std::string &client_id) {
+    auto it = clients_.find(client_id);
+    if (it == clients_.end()) {
+        return false;
+    }
+
+    // Swap-remove from the slot array so it stays dense
+    size_t slot = it->second.roster_slot_;
+    slots_[slot] = slots_.back();
+    slots_[slot]->roster_slot_ = slot;
+    slots_.pop_back();
+
+    clients_.erase(it);
+    return true;
+}
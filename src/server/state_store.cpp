@@ -0,0 +1,259 @@
+#include "server/state_store.hpp"
+#include "crypto/signature.hpp"
+#include "utils/logging.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Writes data to path.tmp, syncs it and renames it over path, so readers see
+// either the old or the new file
+void replaceFile(const std::string &path, const std::string &data,
+                 mode_t mode = 0644) {
+  std::string tmp_path = path + ".tmp";
+  int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, mode);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open " + tmp_path + ": " +
+                             std::strerror(errno));
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = ::write(fd, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      ::close(fd);
+      throw std::runtime_error("Failed to write " + tmp_path + ": " +
+                               std::strerror(errno));
+    }
+    written += static_cast<size_t>(n);
+  }
+  ::fsync(fd);
+  ::close(fd);
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    throw std::runtime_error("Failed to rename " + tmp_path + ": " +
+                             std::strerror(errno));
+  }
+}
+
+} // namespace
+
+StateStore::StateStore(const std::string &directory, bool fsync_writes)
+    : directory_(directory), log_path_(directory + "/wal.jsonl"),
+      snapshot_path_(directory + "/snapshot.json"), fsync_writes_(fsync_writes) {
+  std::filesystem::create_directories(directory_);
+}
+
+StateStore::~StateStore() { close(); }
+
+StateStore::Recovered StateStore::load() {
+  Recovered recovered;
+  uint64_t snapshot_seq = 0;
+
+  std::ifstream snapshot_file(snapshot_path_);
+  if (snapshot_file.is_open()) {
+    nlohmann::json snapshot = nlohmann::json::parse(snapshot_file);
+    snapshot_seq = snapshot.at("seq").get<uint64_t>();
+    recovered.snapshot = std::move(snapshot["state"]);
+  }
+
+  uint64_t last_seq = snapshot_seq;
+  std::ifstream log_file(log_path_);
+  if (log_file.is_open()) {
+    std::string line;
+    std::streamoff valid_bytes = 0;
+    bool torn = false;
+    while (std::getline(log_file, line)) {
+      if (log_file.eof()) {
+        torn = true; // No trailing newline: the write was cut short
+        break;
+      }
+      nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+      if (record.is_discarded() || !record.contains("seq")) {
+        torn = true;
+        break;
+      }
+      valid_bytes += static_cast<std::streamoff>(line.size()) + 1;
+
+      uint64_t seq = record["seq"].get<uint64_t>();
+      if (seq > snapshot_seq) {
+        last_seq = std::max(last_seq, seq);
+        recovered.records.push_back(std::move(record));
+      }
+    }
+    log_file.close();
+
+    if (torn) {
+      DEBUG_WARN("Dropping torn record at the end of " << log_path_);
+      std::filesystem::resize_file(log_path_, static_cast<uintmax_t>(valid_bytes));
+    }
+  }
+
+  next_seq_ = last_seq + 1;
+  durable_seq_ = last_seq;
+  DEBUG_INFO("Loaded state: snapshot at seq " << snapshot_seq << ", "
+             << recovered.records.size() << " log records");
+  return recovered;
+}
+
+void StateStore::openLog() {
+  log_fd_ = ::open(log_path_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (log_fd_ < 0) {
+    throw std::runtime_error("Failed to open " + log_path_ + ": " +
+                             std::strerror(errno));
+  }
+}
+
+void StateStore::open() {
+  openLog();
+  writer_running_ = true;
+  writer_thread_ = std::thread(&StateStore::writerLoop, this);
+}
+
+void StateStore::close() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stopping_ = true;
+  }
+  queue_cv_.notify_all();
+  if (writer_thread_.joinable()) {
+    writer_thread_.join();
+  }
+  if (log_fd_ >= 0) {
+    ::close(log_fd_);
+    log_fd_ = -1;
+  }
+}
+
+uint64_t StateStore::append(nlohmann::json record) {
+  uint64_t seq;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    seq = next_seq_++;
+    record["seq"] = seq;
+    pending_.push_back(std::move(record));
+  }
+  queue_cv_.notify_one();
+  return seq;
+}
+
+void StateStore::waitDurable(uint64_t seq) {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  durable_cv_.wait(lock, [&] { return durable_seq_ >= seq || !writer_running_; });
+}
+
+void StateStore::writeAll(const std::string &data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t n = ::write(log_fd_, data.data() + written, data.size() - written);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      DEBUG_ERROR("Failed to append to " << log_path_ << ": "
+                                         << std::strerror(errno));
+      return;
+    }
+    written += static_cast<size_t>(n);
+  }
+}
+
+void StateStore::writerLoop() {
+  std::vector<nlohmann::json> batch;
+  std::string buffer;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+      if (pending_.empty()) {
+        break; // Stopping and fully flushed
+      }
+      batch.swap(pending_);
+    }
+
+    // One write and at most one sync for everything that queued up meanwhile
+    buffer.clear();
+    for (const auto &record : batch) {
+      buffer += record.dump();
+      buffer += '\n';
+    }
+    uint64_t last_seq = batch.back()["seq"].get<uint64_t>();
+    batch.clear();
+
+    {
+      std::lock_guard<std::mutex> lock(file_mutex_);
+      writeAll(buffer);
+      if (fsync_writes_) {
+        ::fsync(log_fd_);
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      durable_seq_ = last_seq;
+    }
+    durable_cv_.notify_all();
+  }
+
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  writer_running_ = false;
+  durable_cv_.notify_all();
+}
+
+void StateStore::writeSnapshot(const nlohmann::json &state, uint64_t seq) {
+  nlohmann::json snapshot = {{"seq", seq}, {"state", state}};
+  replaceFile(snapshot_path_, snapshot.dump());
+
+  // Compact: keep only the records the snapshot does not cover. Holding
+  // file_mutex_ keeps the writer from appending to the file being replaced.
+  std::lock_guard<std::mutex> lock(file_mutex_);
+  std::ifstream log_file(log_path_);
+  std::string kept;
+  std::string line;
+  while (std::getline(log_file, line)) {
+    nlohmann::json record = nlohmann::json::parse(line, nullptr, false);
+    if (!record.is_discarded() && record.value("seq", uint64_t{0}) > seq) {
+      kept += line;
+      kept += '\n';
+    }
+  }
+  log_file.close();
+
+  replaceFile(log_path_, kept);
+  if (log_fd_ >= 0) {
+    ::close(log_fd_);
+    openLog();
+  }
+  DEBUG_INFO("Wrote snapshot at seq " << seq << ", " << kept.size()
+                                      << " bytes of log retained");
+}
+
+std::pair<std::string, std::string>
+StateStore::loadOrCreateIdentity(const std::string &path) {
+  std::ifstream file(path);
+  if (file.is_open()) {
+    nlohmann::json identity = nlohmann::json::parse(file);
+    return {identity.at("public_key").get<std::string>(),
+            identity.at("private_key").get<std::string>()};
+  }
+
+  auto keypair = SignatureUtils::generateKeyPair();
+  std::filesystem::path parent = std::filesystem::path(path).parent_path();
+  if (!parent.empty()) {
+    std::filesystem::create_directories(parent);
+  }
+  nlohmann::json identity = {{"public_key", keypair.first},
+                             {"private_key", keypair.second}};
+  replaceFile(path, identity.dump(2), 0600);
+  LOG("Generated new server identity at " << path);
+  return keypair;
+}
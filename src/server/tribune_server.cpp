@@ -1,24 +1,120 @@
 #include "crypto/signature.hpp"
+#include "events/aggregation_tree.hpp"
 #include "protocol/parser.hpp"
 #include "server/tribune_server.hpp"
 #include "utils/logging.hpp"
+#include <cmath>
 #include <format>
 #include <iostream>
 #include <shared_mutex>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
+namespace {
+
+ClientInfo clientInfoOf(const ClientState &state) {
+  ClientInfo info;
+  info.client_id = state.client_id_;
+  info.client_host = state.client_host_;
+  info.client_port = state.client_port_;
+  info.ed25519_pub = state.ed25519_pub_;
+  return info;
+}
+
+std::pair<std::string, int> splitHostPort(const std::string &address) {
+  size_t colon = address.rfind(':');
+  return {address.substr(0, colon), std::stoi(address.substr(colon + 1))};
+}
+
+// Per-participant partials of an event's responses, plus who contributed.
+// Aggregation tree submissions are bundles of TreePartials, each standing in
+// for one or more participants of a subtree.
+struct CollectedPartials {
+  std::vector<PartialResult> partials;
+  std::unordered_set<std::string> contributors;
+};
+
+CollectedPartials
+collectPartials(const Event &event,
+                const std::unordered_map<std::string, EventResponse> &responses) {
+  CollectedPartials collected;
+  bool tree = AggregationTree::of(event).has_value();
+  for (const auto &[client_id, response] : responses) {
+    if (!tree) {
+      PartialResult partial;
+      partial.participant_id = client_id;
+      partial.value = nlohmann::json::parse(response.data);
+      collected.partials.push_back(std::move(partial));
+      collected.contributors.insert(client_id);
+      continue;
+    }
+    try {
+      auto bundle = nlohmann::json::parse(response.data).get<std::vector<TreePartial>>();
+      for (auto &entry : bundle) {
+        PartialResult partial;
+        partial.participant_id = std::move(entry.participant_id);
+        partial.value = std::move(entry.value);
+        collected.partials.push_back(std::move(partial));
+        collected.contributors.insert(entry.contributors.begin(),
+                                      entry.contributors.end());
+      }
+    } catch (const std::exception &e) {
+      DEBUG_WARN("Dropping malformed tree bundle from " << client_id << ": "
+                 << e.what());
+    }
+  }
+  return collected;
+}
+
+// Events recovered from disk have no completion; their caller is gone
+void settle(const std::shared_ptr<EventCompletion> &completion,
+            const std::string &event_id, EventStatus status,
+            std::string error) {
+  if (completion) {
+    completion->complete(EventOutcome{.event_id = event_id,
+                                      .status = status,
+                                      .result = std::nullopt,
+                                      .error = std::move(error)});
+  }
+}
+
+} // namespace
+
 TribuneServer::TribuneServer(const std::string &host, int port,
                              const ServerConfig &config)
-    : config_(config), host_(host), port_(port), rng_(rd_()) {
-  // Generate real Ed25519 keypair for server
-  auto keypair = SignatureUtils::generateKeyPair();
+    : shard_ring_(static_cast<size_t>(config.shard_virtual_nodes)),
+      config_(config), host_(host), port_(port), rng_(rd_()) {
+  // Reuse the persisted Ed25519 identity so clients' cached server key stays
+  // valid across restarts; otherwise generate a fresh one
+  auto keypair = config_.identity_file.empty()
+                     ? SignatureUtils::generateKeyPair()
+                     : StateStore::loadOrCreateIdentity(config_.identity_file);
   server_public_key_ = keypair.first;
   server_private_key_ = keypair.second;
 
   // Configure connection pool for TLS if enabled
   connection_pool_.setUseTLS(config_.use_tls);
 
+  if (!config_.shard_peers.empty()) {
+    shard_self_ = host_ + ":" + std::to_string(port_);
+    for (const auto &peer : config_.shard_peers) {
+      shard_ring_.addNode(peer);
+    }
+    if (!shard_ring_.contains(shard_self_)) {
+      DEBUG_WARN("shard_peers does not list this server (" << shard_self_
+                 << "); adding it to the ring");
+      shard_ring_.addNode(shard_self_);
+    }
+    LOG("Sharded coordinator: " << shard_self_ << " is one of "
+        << shard_ring_.nodes().size() << " shards");
+  }
+
+  if (!config_.state_dir.empty()) {
+    state_store_ = std::make_unique<StateStore>(config_.state_dir, config_.wal_fsync);
+    recoverState();
+  }
+
   LOG("Server initialized with Ed25519 public key: " << server_public_key_);
 }
 
@@ -26,8 +122,13 @@ TribuneServer::~TribuneServer() { stop(); }
 void TribuneServer::start() {
   // Start periodic threads
   should_stop_ = false;
-  checker_thread_ = std::thread(&TribuneServer::periodicEventChecker, this);
+  event_deadlines_.start();
+  checker_thread_ = std::thread(&TribuneServer::eventDeadlineChecker, this);
   ping_thread_ = std::thread(&TribuneServer::periodicPinger, this);
+  scheduler_thread_ = std::thread(&TribuneServer::eventScheduler, this);
+  if (state_store_) {
+    snapshot_thread_ = std::thread(&TribuneServer::periodicSnapshotter, this);
+  }
 
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
   if (config_.use_tls) {
@@ -36,27 +137,69 @@ void TribuneServer::start() {
         config_.cert_file.c_str(), 
         config_.private_key_file.c_str()
     );
+    configureHttpServer(ssl_svr_.get());
     setupRoutesForServer(ssl_svr_.get());
     ssl_svr_->listen(host_, port_);
   } else {
 #endif
     LOG("Starting aggregator server on http://" << host_ << ":" << port_);
     svr_ = std::make_unique<httplib::Server>();
+    configureHttpServer(svr_.get());
     setupRoutesForServer(svr_.get());
     svr_->listen(host_, port_);
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
   }
 #endif
+  // httplib destroys the task queue when listen() returns
+  http_queue_ = nullptr;
 }
 
 void TribuneServer::stop() {
-  should_stop_ = true;
+  {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    should_stop_ = true;
+  }
+  stop_cv_.notify_all();
+  event_deadlines_.stop();
+  {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+  }
+  scheduler_cv_.notify_all();
+
   if (checker_thread_.joinable()) {
     checker_thread_.join();
   }
   if (ping_thread_.joinable()) {
     ping_thread_.join();
   }
+  if (scheduler_thread_.joinable()) {
+    scheduler_thread_.join();
+  }
+
+  // Nothing will finalize these anymore; the events themselves stay in the
+  // snapshot and resume on the next start. Callbacks run outside the locks.
+  std::vector<std::pair<std::string, std::shared_ptr<EventCompletion>>> cancelled;
+  {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    for (auto &pending : pending_events_) {
+      cancelled.emplace_back(pending.event_id, std::move(pending.completion));
+    }
+    pending_events_.clear();
+  }
+  {
+    std::shared_lock<std::shared_mutex> lock(active_events_mutex_);
+    for (const auto &[event_id, active_event] : active_events_) {
+      cancelled.emplace_back(event_id, active_event.completion);
+    }
+  }
+  for (const auto &[event_id, completion] : cancelled) {
+    settle(completion, event_id, EventStatus::Cancelled, "Server stopped");
+  }
+  if (snapshot_thread_.joinable()) {
+    snapshot_thread_.join();
+    // A fresh snapshot keeps the next start from replaying the whole log
+    writeSnapshot();
+  }
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
   if (ssl_svr_) {
     ssl_svr_->stop();
@@ -67,6 +210,44 @@ void TribuneServer::stop() {
   }
 }
 
+template<typename ServerType>
+void TribuneServer::configureHttpServer(ServerType* server) {
+  size_t workers = config_.http_worker_threads > 0
+                       ? static_cast<size_t>(config_.http_worker_threads)
+                       : std::max(8u, std::thread::hardware_concurrency());
+  size_t max_queued = static_cast<size_t>(config_.http_max_queued_requests);
+
+  server->new_task_queue = [this, workers, max_queued]() -> httplib::TaskQueue * {
+    // Past twice the shedding threshold, connections are dropped unanswered
+    auto *queue = new BoundedTaskQueue(workers, max_queued, max_queued * 2);
+    http_queue_ = queue;
+    return queue;
+  };
+
+  // Runs on a worker before routing: while the backlog is saturated, answer
+  // with a cheap 503 instead of doing the work and queueing further behind
+  server->set_pre_routing_handler(
+      [this](const httplib::Request &req, httplib::Response &res) {
+        BoundedTaskQueue *queue = http_queue_;
+        if (queue && queue->saturated()) {
+          DEBUG_WARN("Shedding " << req.path << ": " << queue->queued()
+                                 << " connections queued");
+          res.status = 503;
+          res.set_header("Retry-After",
+                         std::to_string(config_.http_retry_after_seconds));
+          res.set_content("{\"error\":\"Server busy\"}", "application/json");
+          return httplib::Server::HandlerResponse::Handled;
+        }
+        return httplib::Server::HandlerResponse::Unhandled;
+      });
+
+  server->set_payload_max_length(static_cast<size_t>(config_.http_payload_max_bytes));
+  server->set_keep_alive_max_count(static_cast<size_t>(config_.http_keep_alive_max_count));
+  server->set_keep_alive_timeout(config_.http_keep_alive_timeout_seconds);
+  server->set_read_timeout(config_.http_read_timeout_seconds, 0);
+  server->set_write_timeout(config_.http_write_timeout_seconds, 0);
+}
+
 template<typename ServerType>
 void TribuneServer::setupRoutesForServer(ServerType* server) {
   // Simple GET endpoint
@@ -95,11 +276,18 @@ void TribuneServer::setupRoutesForServer(ServerType* server) {
            [this](const httplib::Request &req, httplib::Response &res) {
              this->handleEndpointPing(req, res);
            });
+
+  server->Post("/shard/roster-sample",
+           [this](const httplib::Request &req, httplib::Response &res) {
+             this->handleEndpointShardRosterSample(req, res);
+           });
 }
 
 // Explicit template instantiations
+template void TribuneServer::configureHttpServer<httplib::Server>(httplib::Server*);
 template void TribuneServer::setupRoutesForServer<httplib::Server>(httplib::Server*);
 #ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+template void TribuneServer::configureHttpServer<httplib::SSLServer>(httplib::SSLServer*);
 template void TribuneServer::setupRoutesForServer<httplib::SSLServer>(httplib::SSLServer*);
 #endif
 
@@ -131,6 +319,21 @@ void TribuneServer::handleEndpointConnect(const httplib::Request &req,
     DEBUG_DEBUG("Succesfully parsed ConnectResponse from Client with ID: "
                 << parsed_res.client_id);
 
+    // In sharded mode each client belongs to exactly one shard
+    if (sharded()) {
+      const std::string &owner = shard_ring_.ownerOf(parsed_res.client_id);
+      if (owner != shard_self_) {
+        DEBUG_DEBUG("Redirecting client " << parsed_res.client_id << " to shard "
+                                          << owner);
+        res.status = 307;
+        res.set_header("Location", std::string(config_.use_tls ? "https://" : "http://") +
+                                       owner + "/connect");
+        res.set_content(nlohmann::json{{"redirect", owner}}.dump(),
+                        "application/json");
+        return;
+      }
+    }
+
     ClientState state(parsed_res.client_host, parsed_res.client_port,
                       parsed_res.client_id, parsed_res.ed25519_pub);
     state.updatePingTime();
@@ -138,11 +341,15 @@ void TribuneServer::handleEndpointConnect(const httplib::Request &req,
     DEBUG_INFO("Adding client to roster with ID: '" << parsed_res.client_id
                                                     << "'");
 
+    uint64_t seq;
     {
       std::unique_lock<std::shared_mutex> lock(roster_mutex_);
-      this->roster_[parsed_res.client_id] = state;
+      this->roster_.upsert(state);
       DEBUG_DEBUG("Roster size after adding: " << this->roster_.size());
+
+      seq = logState({{"op", "connect"}, {"client", clientInfoOf(state)}});
     }
+    awaitState(seq);
 
     res.status = 200;
     nlohmann::json response = {{"received", true},
@@ -166,9 +373,11 @@ void TribuneServer::handleEndpointSubmit(const httplib::Request &req,
     // Show progress: received X/Y sub results
     int received_count = 0;
     int expected_count = 0;
+    std::optional<std::chrono::steady_clock::time_point> created_time;
+    bool is_participant = false; // May be connected to another shard
     {
-      std::shared_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
       std::shared_lock<std::shared_mutex> events_lock(active_events_mutex_);
+      std::shared_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
 
       auto responses_it = unprocessed_responses_.find(parsed_res.event_id);
       if (responses_it != unprocessed_responses_.end()) {
@@ -181,6 +390,13 @@ void TribuneServer::handleEndpointSubmit(const httplib::Request &req,
       auto active_it = active_events_.find(parsed_res.event_id);
       if (active_it != active_events_.end()) {
         expected_count = active_it->second.expected_participants;
+        created_time = active_it->second.created_time;
+        for (const auto &participant : active_it->second.event.participants) {
+          if (participant.client_id == parsed_res.client_id) {
+            is_participant = true;
+            break;
+          }
+        }
       }
     }
 
@@ -200,17 +416,44 @@ void TribuneServer::handleEndpointSubmit(const httplib::Request &req,
         DEBUG_DEBUG("  - '" << id << "'");
       }
 
-      if (this->roster_.find(parsed_res.client_id) != this->roster_.end()) {
+      if (is_participant ||
+          this->roster_.find(parsed_res.client_id) != this->roster_.end()) {
         roster_lock.unlock();
-        {
-          std::unique_lock<std::shared_mutex> responses_lock(
-              unprocessed_responses_mutex_);
-          this->unprocessed_responses_[parsed_res.event_id]
-                                     [parsed_res.client_id] = parsed_res;
-        }
 
-        // Check if we can aggregate results for any completed events
-        checkForCompleteResults();
+        // Late submissions (event already finalized or expired) are
+        // acknowledged but not stored, or they would never be cleaned up
+        if (created_time) {
+          uint64_t seq = 0;
+          {
+            std::shared_lock<std::shared_mutex> events_lock(active_events_mutex_);
+            std::unique_lock<std::shared_mutex> responses_lock(
+                unprocessed_responses_mutex_);
+            if (active_events_.find(parsed_res.event_id) != active_events_.end()) {
+              this->unprocessed_responses_[parsed_res.event_id]
+                                         [parsed_res.client_id] = parsed_res;
+              seq = logState({{"op", "response"}, {"response", parsed_res}});
+            }
+          }
+          // Only acknowledge a result once it would survive a restart
+          awaitState(seq);
+
+          double latency_ms = std::chrono::duration<double, std::milli>(
+                                  std::chrono::steady_clock::now() - *created_time)
+                                  .count();
+          {
+            std::unique_lock<std::shared_mutex> lock(roster_mutex_);
+            auto client_it = roster_.find(parsed_res.client_id);
+            if (client_it != roster_.end()) {
+              client_it->second.recordResponseLatency(latency_ms);
+            }
+          }
+
+          // Check if we can aggregate results for any completed events
+          checkForCompleteResults();
+        } else {
+          DEBUG_DEBUG("Ignoring late result for inactive event "
+                      << parsed_res.event_id);
+        }
 
         res.status = 200;
         res.set_content("{\"received\":true}", "application/json");
@@ -231,7 +474,20 @@ void TribuneServer::handleEndpointSubmit(const httplib::Request &req,
   }
 }
 
-void TribuneServer::announceEvent(const Event &event, std::string *result) {
+std::future<FinalResult> TribuneServer::announceEvent(const Event &event) {
+  auto [callback, future] = futureCallback();
+  announceEvent(event, std::move(callback));
+  return std::move(future);
+}
+
+void TribuneServer::announceEvent(const Event &event, EventCallback on_complete) {
+  if (openEvent(event, std::make_shared<EventCompletion>(std::move(on_complete)))) {
+    sendAnnouncements(event);
+  }
+}
+
+bool TribuneServer::openEvent(const Event &event,
+                              std::shared_ptr<EventCompletion> completion) {
   // VALIDATE event before announcing to catch signature/timestamp issues
   if (event.server_signature.empty()) {
     DEBUG_ERROR("ERROR: Event " << event.event_id
@@ -241,6 +497,54 @@ void TribuneServer::announceEvent(const Event &event, std::string *result) {
     DEBUG_ERROR("ERROR: Event " << event.event_id << " has zero timestamp!");
   }
 
+  ModuleRegistry::Handle module = modules_.find(event.computation_type);
+  int expected = static_cast<int>(event.participants.size());
+  int threshold = requiredResponses(module.get(), expected);
+  // Over-provisioned threshold events finalize as soon as the threshold is met.
+  // Both count participants; for tree events, via the contributors listed in
+  // each bundle.
+  int quorum = config_.speculative_extra_participants > 0 ? threshold : expected;
+  auto created_time = std::chrono::steady_clock::now();
+  uint64_t seq;
+  {
+    std::unique_lock<std::shared_mutex> lock(active_events_mutex_);
+    // The running event keeps its state; responses are keyed by event ID, so
+    // a second event under the same ID could never be told apart from it
+    if (active_events_.count(event.event_id)) {
+      lock.unlock();
+      DEBUG_ERROR("Event " << event.event_id << " is already active");
+      settle(completion, event.event_id, EventStatus::Failed, "duplicate event id");
+      return false;
+    }
+    seq = logState({{"op", "event_open"},
+                    {"event", event},
+                    {"threshold", threshold},
+                    {"quorum", quorum},
+                    {"created_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch())
+                                       .count()}});
+    active_events_.emplace(event.event_id,
+                           ActiveEvent{
+                               .event_id = event.event_id,
+                               .computation_type = event.computation_type,
+                               .expected_participants = expected,
+                               .threshold = threshold,
+                               .quorum = quorum,
+                               .created_time = created_time,
+                               .completion = std::move(completion),
+                               .module = std::move(module),
+                               .event = event // Store the actual event
+                           });
+  }
+  // Participants must not submit for an event a restarted server forgot
+  awaitState(seq);
+  event_deadlines_.schedule(
+      event.event_id,
+      created_time + std::chrono::seconds(config_.event_timeout_boundary));
+  return true;
+}
+
+void TribuneServer::sendAnnouncements(const Event &event) {
   // Convert Event to JSON string using automatic conversion
   nlohmann::json j = event;
   std::string json_str = j.dump();
@@ -256,20 +560,6 @@ void TribuneServer::announceEvent(const Event &event, std::string *result) {
                      .count()
               << "ms");
 
-  {
-    std::unique_lock<std::shared_mutex> lock(active_events_mutex_);
-    active_events_.emplace(event.event_id,
-                           ActiveEvent{
-                               .event_id = event.event_id,
-                               .computation_type = event.computation_type,
-                               .expected_participants =
-                                   static_cast<int>(event.participants.size()),
-                               .created_time = std::chrono::steady_clock::now(),
-                               .result_ptr = result,
-                               .event = event // Store the actual event
-                           });
-  }
-
   // Send event announcements with timeouts and controlled concurrency
   std::vector<std::thread> announcement_threads;
 
@@ -314,50 +604,396 @@ void TribuneServer::announceEvent(const Event &event, std::string *result) {
   DEBUG_DEBUG("All event announcements completed for event " << event.event_id);
 }
 
-std::vector<ClientInfo> TribuneServer::selectParticipants() {
-  // Get all active participating clients
-  std::vector<ClientInfo> active_clients;
+std::future<FinalResult>
+TribuneServer::submitEvent(EventType type, const std::string &event_id,
+                           const std::string &computation_type,
+                           nlohmann::json computation_metadata) {
+  auto [callback, future] = futureCallback();
+  submitEvent(type, event_id, computation_type, std::move(computation_metadata),
+              std::move(callback));
+  return std::move(future);
+}
 
-  std::shared_lock<std::shared_mutex> lock(roster_mutex_);
-  for (const auto &[client_id, client_state] : roster_) {
-    ClientInfo info;
-    info.client_id = client_state.client_id_;
-    info.client_host = client_state.client_host_;
-    info.client_port = client_state.client_port_;
-    info.ed25519_pub = client_state.ed25519_pub_;
-    active_clients.push_back(info);
+EventAwaiter TribuneServer::awaitEvent(EventType type, const std::string &event_id,
+                                       const std::string &computation_type,
+                                       nlohmann::json computation_metadata) {
+  return EventAwaiter([=, this](EventCallback on_complete) {
+    submitEvent(type, event_id, computation_type, computation_metadata,
+                std::move(on_complete));
+  });
+}
+
+void TribuneServer::submitEvent(EventType type, const std::string &event_id,
+                                const std::string &computation_type,
+                                nlohmann::json computation_metadata,
+                                EventCallback on_complete) {
+  auto completion = std::make_shared<EventCompletion>(std::move(on_complete));
+  {
+    std::lock_guard<std::mutex> lock(event_mutex_);
+    pending_events_.push_back(PendingEvent{.type = type,
+                                           .event_id = event_id,
+                                           .computation_type = computation_type,
+                                           .computation_metadata =
+                                               std::move(computation_metadata),
+                                           .completion = std::move(completion),
+                                           .deadline = std::chrono::steady_clock::now() +
+                                                       std::chrono::seconds(
+                                                           config_.event_timeout_boundary)});
+  }
+  scheduler_cv_.notify_all();
+}
+
+int TribuneServer::eventsInFlight() {
+  std::shared_lock<std::shared_mutex> lock(active_events_mutex_);
+  return static_cast<int>(active_events_.size());
+}
+
+std::unordered_set<std::string> TribuneServer::busyParticipants() {
+  std::unordered_set<std::string> busy;
+  std::shared_lock<std::shared_mutex> lock(active_events_mutex_);
+  for (const auto &[event_id, active_event] : active_events_) {
+    for (const auto &participant : active_event.event.participants) {
+      busy.insert(participant.client_id);
+    }
+  }
+  return busy;
+}
+
+void TribuneServer::eventScheduler() {
+  DEBUG_INFO("Started event scheduler thread");
+
+  using Clock = std::chrono::steady_clock;
+  const bool recurring = !config_.scheduled_computation_type.empty();
+  const auto interval = std::chrono::seconds(config_.event_announce_interval_seconds);
+  auto next_recurring = Clock::now() + interval;
+  // Set when too few clients were connected to create the head event
+  auto retry_at = Clock::time_point::min();
+  uint64_t recurring_count = 0;
+
+  while (!should_stop_) {
+    PendingEvent next;
+    {
+      std::unique_lock<std::mutex> lock(event_mutex_);
+      auto wake = recurring ? next_recurring : Clock::now() + interval;
+      if (retry_at > Clock::now()) {
+        wake = std::min(wake, retry_at);
+      }
+      scheduler_cv_.wait_until(lock, wake, [&] {
+        return should_stop_ ||
+               (!pending_events_.empty() && Clock::now() >= retry_at &&
+                eventsInFlight() < config_.max_events_in_flight);
+      });
+      if (should_stop_) {
+        break;
+      }
+
+      if (recurring && Clock::now() >= next_recurring) {
+        pending_events_.push_back(PendingEvent{
+            .type = DataRequestEvent,
+            .event_id = "scheduled-" + std::to_string(
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch())
+                    .count()) + "-" + std::to_string(recurring_count++),
+            .computation_type = config_.scheduled_computation_type,
+            .computation_metadata = nlohmann::json::object(),
+            .completion = nullptr,
+            .deadline = Clock::now() + std::chrono::seconds(config_.event_timeout_boundary)});
+        next_recurring = std::max(next_recurring + interval, Clock::now());
+      }
+
+      if (pending_events_.empty() || Clock::now() < retry_at ||
+          eventsInFlight() >= config_.max_events_in_flight) {
+        continue;
+      }
+      next = std::move(pending_events_.front());
+      pending_events_.pop_front();
+    }
+
+    // Spread concurrent events over idle clients while there are enough
+    auto event = buildEvent(next.type, next.event_id, next.computation_type,
+                            next.computation_metadata,
+                            config_.scheduler_disjoint_participants
+                                ? busyParticipants()
+                                : std::unordered_set<std::string>{});
+    if (!event) {
+      if (Clock::now() >= next.deadline) {
+        DEBUG_WARN("Not enough clients for event " << next.event_id
+                   << " before its deadline");
+        settle(next.completion, next.event_id, EventStatus::TimedOut,
+               "Not enough clients before event_timeout_boundary");
+        retry_at = Clock::time_point::min();
+        continue;
+      }
+      DEBUG_DEBUG("Not enough clients for event " << next.event_id
+                  << "; retrying");
+      retry_at = Clock::now() + std::chrono::seconds(1);
+      std::lock_guard<std::mutex> lock(event_mutex_);
+      pending_events_.push_front(std::move(next));
+      continue;
+    }
+    retry_at = Clock::time_point::min();
+
+    // Registered before the next iteration counts events in flight; the
+    // fan-out to participants blocks, so it runs beside the scheduler
+    if (!openEvent(*event, std::move(next.completion))) {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(stop_mutex_);
+      announcing_events_++;
+    }
+    std::thread([this, event = std::move(*event)]() {
+      sendAnnouncements(event);
+      {
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        announcing_events_--;
+      }
+      stop_cv_.notify_all();
+    }).detach();
   }
 
-  DEBUG_DEBUG("Found " << active_clients.size() << " active clients");
+  // Announcement threads use the connection pool, which stop() outlives
+  std::unique_lock<std::mutex> lock(stop_mutex_);
+  stop_cv_.wait(lock, [this] { return announcing_events_ == 0; });
+
+  DEBUG_INFO("Event scheduler thread stopped");
+}
+
+std::vector<ClientInfo>
+TribuneServer::selectParticipants(int extra_participants,
+                                  const std::unordered_set<std::string> &avoid) {
+  std::shared_lock<std::shared_mutex> lock(roster_mutex_);
+  int active_count = static_cast<int>(roster_.size());
+
+  DEBUG_DEBUG("Found " << active_count << " active clients");
+
+  // Restrict the draw to idle clients, unless that leaves too few
+  std::vector<size_t> idle_slots;
+  if (!avoid.empty()) {
+    for (size_t i = 0; i < roster_.size(); i++) {
+      if (!avoid.count(roster_.at(i).client_id_)) {
+        idle_slots.push_back(i);
+      }
+    }
+    if (static_cast<int>(idle_slots.size()) >= config_.min_participants) {
+      active_count = static_cast<int>(idle_slots.size());
+    } else {
+      DEBUG_DEBUG("Only " << idle_slots.size()
+                  << " idle clients; overlapping active events");
+      idle_slots.clear();
+    }
+  }
 
   // Check minimum threshold
-  if (static_cast<int>(active_clients.size()) < config_.min_participants) {
-    DEBUG_DEBUG("Not enough participants (" << active_clients.size() << " < "
+  if (active_count < config_.min_participants) {
+    DEBUG_DEBUG("Not enough participants (" << active_count << " < "
                                             << config_.min_participants << ")");
     return {};
   }
 
   // Determine participant count
-  int participant_count = std::min(static_cast<int>(active_clients.size()),
-                                   config_.max_participants);
+  size_t participant_count = static_cast<size_t>(std::min(
+      active_count, config_.max_participants + extra_participants));
+
+  // Pick roster slots first; only the chosen clients are copied out
+  std::vector<size_t> slots;
+  if (config_.weighted_selection) {
+    // Weighted sampling without replacement (Efraimidis-Spirakis): draw
+    // key = u^(1/w) per client and keep the largest keys. Still O(roster)
+    // to score, but copies nothing per unselected client.
+    std::vector<std::pair<double, size_t>> keys(roster_.size());
+    {
+      std::lock_guard<std::mutex> rng_lock(rng_mutex_);
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      for (size_t i = 0; i < roster_.size(); i++) {
+        keys[i] = {std::pow(uniform(rng_), 1.0 / roster_.at(i).selectionWeight()), i};
+      }
+      // Keys are in [0, 1], so busy clients sort after every idle one
+      if (!idle_slots.empty()) {
+        for (auto &key : keys) {
+          if (avoid.count(roster_.at(key.second).client_id_)) {
+            key.first = -1.0;
+          }
+        }
+      }
+    }
+    std::partial_sort(keys.begin(), keys.begin() + participant_count, keys.end(),
+                      std::greater<>());
+    for (size_t i = 0; i < participant_count; i++) {
+      slots.push_back(keys[i].second);
+    }
+  } else if (!idle_slots.empty()) {
+    std::lock_guard<std::mutex> rng_lock(rng_mutex_);
+    std::sample(idle_slots.begin(), idle_slots.end(), std::back_inserter(slots),
+                participant_count, rng_);
+    std::shuffle(slots.begin(), slots.end(), rng_);
+  } else {
+    // Uniform random selection in O(k)
+    std::lock_guard<std::mutex> rng_lock(rng_mutex_);
+    slots = roster_.sampleSlots(participant_count, rng_);
+  }
 
-  // Random selection
+  std::vector<ClientInfo> selected;
+  selected.reserve(slots.size());
+  for (size_t slot : slots) {
+    selected.push_back(clientInfoOf(roster_.at(slot)));
+  }
+
+  DEBUG_DEBUG("Selected " << selected.size() << " participants");
+  return selected;
+}
+
+std::pair<size_t, std::vector<ClientInfo>>
+TribuneServer::sampleRoster(size_t count) {
+  std::shared_lock<std::shared_mutex> lock(roster_mutex_);
+  std::vector<size_t> slots;
   {
     std::lock_guard<std::mutex> rng_lock(rng_mutex_);
-    std::shuffle(active_clients.begin(), active_clients.end(), rng_);
+    slots = roster_.sampleSlots(count, rng_);
   }
 
-  std::vector<ClientInfo> selected(active_clients.begin(),
-                                   active_clients.begin() + participant_count);
+  std::vector<ClientInfo> sample;
+  sample.reserve(slots.size());
+  for (size_t slot : slots) {
+    sample.push_back(clientInfoOf(roster_.at(slot)));
+  }
+  return {roster_.size(), std::move(sample)};
+}
 
-  DEBUG_DEBUG("Selected " << selected.size() << " participants");
+std::vector<ClientInfo>
+TribuneServer::selectParticipantsAcrossShards(int extra_participants) {
+  size_t wanted = static_cast<size_t>(config_.max_participants + extra_participants);
+
+  // Every shard returns a uniform sample of up to `wanted` of its clients
+  // and its roster size. Peers are queried concurrently.
+  std::vector<std::pair<size_t, std::vector<ClientInfo>>> samples;
+  samples.push_back(sampleRoster(wanted));
+
+  std::vector<std::string> peers;
+  for (const auto &node : shard_ring_.nodes()) {
+    if (node != shard_self_) {
+      peers.push_back(node);
+    }
+  }
+  std::vector<std::optional<std::pair<size_t, std::vector<ClientInfo>>>>
+      peer_samples(peers.size());
+  std::vector<std::thread> requests;
+  std::string body = nlohmann::json{{"count", wanted}}.dump();
+  for (size_t i = 0; i < peers.size(); i++) {
+    requests.emplace_back([this, &peers, &peer_samples, &body, i]() {
+      try {
+        auto [host, port] = splitHostPort(peers[i]);
+        connection_pool_.withConnection(host, port, [&](auto *client) {
+          auto res = client->Post("/shard/roster-sample", body, "application/json");
+          if (res && res->status == 200) {
+            nlohmann::json j = nlohmann::json::parse(res->body);
+            peer_samples[i].emplace(j.at("roster_size").get<size_t>(),
+                                    j.at("clients").get<std::vector<ClientInfo>>());
+          } else {
+            DEBUG_WARN("Shard " << peers[i] << " did not return a roster sample");
+          }
+          return true;
+        });
+      } catch (const std::exception &e) {
+        DEBUG_WARN("Roster sample from shard " << peers[i] << " failed: " << e.what());
+      }
+    });
+  }
+  for (auto &request : requests) {
+    request.join();
+  }
+  for (auto &peer_sample : peer_samples) {
+    if (peer_sample) {
+      samples.push_back(std::move(*peer_sample));
+    }
+  }
+
+  size_t total = 0;
+  for (const auto &[roster_size, clients] : samples) {
+    total += roster_size;
+  }
+  if (total < static_cast<size_t>(config_.min_participants)) {
+    DEBUG_DEBUG("Not enough participants across shards (" << total << " < "
+                                                          << config_.min_participants << ")");
+    return {};
+  }
+
+  // Uniform over the union of rosters: draw shards without replacement in
+  // proportion to their unsampled clients (multivariate hypergeometric), then
+  // take that many from the front of each shard's already-uniform sample
+  std::vector<size_t> unsampled;
+  for (const auto &[roster_size, clients] : samples) {
+    unsampled.push_back(roster_size);
+  }
+  std::vector<size_t> taken(samples.size(), 0);
+  std::unordered_set<std::string> seen; // A client moving shards may briefly be on two rosters
+  std::vector<ClientInfo> selected;
+  {
+    std::lock_guard<std::mutex> rng_lock(rng_mutex_);
+    size_t remaining_total = total;
+    while (selected.size() < wanted && remaining_total > 0) {
+      size_t pick = std::uniform_int_distribution<size_t>(0, remaining_total - 1)(rng_);
+      size_t shard = 0;
+      while (pick >= unsampled[shard]) {
+        pick -= unsampled[shard];
+        shard++;
+      }
+      unsampled[shard]--;
+      remaining_total--;
+
+      const auto &shard_sample = samples[shard].second;
+      if (taken[shard] < shard_sample.size()) {
+        const ClientInfo &client = shard_sample[taken[shard]++];
+        if (seen.insert(client.client_id).second) {
+          selected.push_back(client);
+        }
+      }
+    }
+  }
+
+  DEBUG_DEBUG("Selected " << selected.size() << " participants across "
+                          << samples.size() << " shards");
   return selected;
 }
 
+void TribuneServer::handleEndpointShardRosterSample(const httplib::Request &req,
+                                                    httplib::Response &res) {
+  try {
+    size_t count = nlohmann::json::parse(req.body).at("count").get<size_t>();
+    auto [roster_size, clients] = sampleRoster(count);
+    res.status = 200;
+    res.set_content(nlohmann::json{{"roster_size", roster_size},
+                                   {"clients", clients}}
+                        .dump(),
+                    "application/json");
+  } catch (const std::exception &e) {
+    res.status = 400;
+    res.set_content("{\"error\":\"Invalid request\"}", "application/json");
+  }
+}
+
 std::optional<Event>
 TribuneServer::createEvent(EventType type, const std::string &event_id,
                            const std::string &computation_type) {
-  auto participants = selectParticipants();
+  return buildEvent(type, event_id, computation_type, nlohmann::json::object(), {});
+}
+
+std::optional<Event>
+TribuneServer::buildEvent(EventType type, const std::string &event_id,
+                          const std::string &computation_type,
+                          const nlohmann::json &computation_metadata,
+                          const std::unordered_set<std::string> &avoid) {
+  // Over-provisioning only helps threshold modules; others need everyone
+  int extra_participants = 0;
+  if (config_.speculative_extra_participants > 0) {
+    auto module = modules_.find(computation_type);
+    if (module && module->getProtocolMetadata().threshold > 0) {
+      extra_participants = config_.speculative_extra_participants;
+    }
+  }
+
+  auto participants = sharded() ? selectParticipantsAcrossShards(extra_participants)
+                                : selectParticipants(extra_participants, avoid);
 
   if (participants.empty()) {
     return std::nullopt;
@@ -368,11 +1004,22 @@ TribuneServer::createEvent(EventType type, const std::string &event_id,
   event.event_id = event_id;
   event.computation_type = computation_type;
   event.participants = std::move(participants);
+  event.computation_metadata = computation_metadata;
   event.timestamp = std::chrono::system_clock::now();
+  if (sharded()) {
+    // Participants connected to other shards submit their results here
+    event.aggregator = shard_self_;
+  }
+  if (config_.aggregation_tree_fan_in > 0 &&
+      static_cast<int>(event.participants.size()) >=
+          config_.aggregation_tree_min_participants) {
+    event.computation_metadata["aggregation_tree"] = {
+        {"fan_in", config_.aggregation_tree_fan_in},
+        {"level_timeout_ms", config_.aggregation_tree_level_timeout_ms}};
+  }
 
   // Create server signature for event verification
-  std::string event_hash = event.event_id + "|" + event.computation_type + "|" +
-                           std::to_string(event.participants.size());
+  std::string event_hash = eventSignaturePayload(event);
   DEBUG_DEBUG("SERVER: Creating signature for event hash: " << event_hash);
   event.server_signature =
       SignatureUtils::createSignature(event_hash, server_private_key_);
@@ -383,8 +1030,7 @@ TribuneServer::createEvent(EventType type, const std::string &event_id,
 
 void TribuneServer::registerModule(
     const std::string &type, std::unique_ptr<MPCModule> module) {
-  std::unique_lock<std::shared_mutex> lock(modules_mutex_);
-  modules_[type] = std::move(module);
+  modules_.add(type, std::move(module));
   DEBUG_INFO("Server registered MPC computation: " << type);
 }
 
@@ -394,8 +1040,9 @@ void TribuneServer::handleEndpointPing(const httplib::Request &req,
     EventResponse parsed_res = *result;
     
     std::unique_lock<std::shared_mutex> lock(roster_mutex_);
-    if (roster_.find(parsed_res.client_id) != roster_.end()) {
-      roster_[parsed_res.client_id].updatePingTime();
+    auto client_it = roster_.find(parsed_res.client_id);
+    if (client_it != roster_.end()) {
+      client_it->second.updatePingTime();
       res.status = 200;
       res.set_content("{\"status\":\"pong\"}", "application/json");
     } else {
@@ -408,138 +1055,249 @@ void TribuneServer::handleEndpointPing(const httplib::Request &req,
   }
 }
 
-void TribuneServer::checkForCompleteResults() {
-  std::shared_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
-  std::shared_lock<std::shared_mutex> events_lock(active_events_mutex_);
+int TribuneServer::requiredResponses(const MPCModule *module,
+                                     int expected_participants) {
+  if (!module) {
+    return expected_participants;
+  }
 
-  std::vector<std::string> completed_events;
+  // Threshold of 0 means the protocol needs every participant's partial
+  int threshold = module->getProtocolMetadata().threshold;
+  if (threshold <= 0 || threshold > expected_participants) {
+    return expected_participants;
+  }
+  return threshold;
+}
 
-  // Check each active event
-  for (const auto &[event_id, active_event] : active_events_) {
-    auto responses_it = unprocessed_responses_.find(event_id);
+void TribuneServer::finalizeEvent(
+    const ActiveEvent &active_event,
+    const std::unordered_map<std::string, EventResponse> &responses,
+    bool degraded) {
+  // Called on events already claimed out of active_events_, so no server
+  // lock is needed. The outcome is delivered afterwards, so callbacks may
+  // use the server.
+  EventOutcome outcome{.event_id = active_event.event_id,
+                       .status = EventStatus::Failed,
+                       .result = std::nullopt,
+                       .error = ""};
+  finalizeWithModule(active_event, responses, degraded, outcome);
+  if (active_event.completion) {
+    active_event.completion->complete(outcome);
+  }
+}
 
-    // Count received responses
-    int received_count = 0;
-    std::vector<std::string> results;
+void TribuneServer::finalizeWithModule(
+    const ActiveEvent &active_event,
+    const std::unordered_map<std::string, EventResponse> &responses,
+    bool degraded, EventOutcome &outcome) {
+  ModuleRegistry::Handle module = active_event.module
+                                      ? active_event.module
+                                      : modules_.find(active_event.computation_type);
+
+  if (!module) {
+    DEBUG_DEBUG("No module handler for type: " << active_event.computation_type);
+    outcome.error = "No module registered for type: " + active_event.computation_type;
+    return;
+  }
 
-    if (responses_it != unprocessed_responses_.end()) {
-      received_count = static_cast<int>(responses_it->second.size());
-      for (const auto &[client_id, response] : responses_it->second) {
-        results.push_back(response.data);
+  try {
+    // Convert submitted results to PartialResult objects, keyed by the
+    // submitting client so threshold modules can tell who contributed
+    CollectedPartials collected = collectPartials(active_event.event, responses);
+
+    // Aggregate the partial results
+    FinalResult final =
+        module->aggregate(collected.partials, &active_event.event);
+    final.degraded = degraded;
+    final.contributing_participants =
+        static_cast<int>(collected.contributors.size());
+    std::string final_result = final.value.dump();
+
+    DEBUG_DEBUG("=== FINAL MPC RESULT ===");
+    DEBUG_DEBUG("Event: " << active_event.event_id);
+    DEBUG_DEBUG("Computation: " << active_event.computation_type);
+    DEBUG_DEBUG("Final Result: " << final_result);
+    if (degraded) {
+      DEBUG_DEBUG("Degraded: " << final.contributing_participants << "/"
+                               << active_event.expected_participants
+                               << " participants contributed");
+    }
+    DEBUG_DEBUG("========================");
+
+    outcome.status = EventStatus::Completed;
+    outcome.result = std::move(final);
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Aggregation failed for event " << active_event.event_id
+                                                << ": " << e.what());
+    outcome.error = e.what();
+  }
+}
+
+void TribuneServer::checkForCompleteResults() {
+  std::vector<std::string> completed_events;
+  {
+    std::shared_lock<std::shared_mutex> events_lock(active_events_mutex_);
+    std::shared_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
+
+    // Check each active event
+    for (const auto &[event_id, active_event] : active_events_) {
+      auto responses_it = unprocessed_responses_.find(event_id);
+      if (responses_it == unprocessed_responses_.end()) {
+        continue;
+      }
+
+      // Check if we have all expected responses (or the quorum when over-provisioned)
+      int received_count = static_cast<int>(responses_it->second.size());
+      if (AggregationTree::of(active_event.event)) {
+        // Top-level nodes forward at their level deadline even with children
+        // missing, so count the participants their bundles stand for. Short
+        // events wait for the deadline, which degrades or times them out.
+        received_count = static_cast<int>(
+            collectPartials(active_event.event, responses_it->second).contributors.size());
+      }
+      if (received_count >= active_event.quorum) {
+        DEBUG_DEBUG("Event " << event_id << " is complete (" << received_count
+                             << "/" << active_event.expected_participants
+                             << " responses)");
+        completed_events.push_back(event_id);
       }
     }
+  }
 
-    // Check if we have all expected responses
-    if (received_count >= active_event.expected_participants) {
-      DEBUG_DEBUG("Event " << event_id << " is complete (" << received_count
-                           << "/" << active_event.expected_participants
-                           << " responses)");
+  if (completed_events.empty()) {
+    return;
+  }
 
-      std::shared_lock<std::shared_mutex> mod_lock(modules_mutex_);
-      auto mod_it = modules_.find(active_event.computation_type);
+  // Claim the events under exclusive locks so each is finalized exactly once,
+  // even when several submit threads see it complete at the same time
+  auto claimed = claimEvents(completed_events);
 
-      if (mod_it != modules_.end()) {
-        // Convert string results to PartialResult objects
-        std::vector<PartialResult> partials;
-        for (size_t i = 0; i < results.size(); i++) {
-          PartialResult partial;
-          partial.participant_id = "participant_" + std::to_string(i);
-          partial.value = nlohmann::json::parse(results[i]);
-          partials.push_back(partial);
-        }
-        
-        // Aggregate the partial results
-        FinalResult final = mod_it->second->aggregate(partials, &active_event.event);
-        std::string final_result = final.value.dump();
-        
-        DEBUG_DEBUG("=== FINAL MPC RESULT ===");
-        DEBUG_DEBUG("Event: " << event_id);
-        DEBUG_DEBUG("Computation: " << active_event.computation_type);
-        DEBUG_DEBUG("Final Result: " << final_result);
-        DEBUG_DEBUG("========================");
-
-        // Store result in provided pointer if available
-        if (active_event.result_ptr != nullptr) {
-          *active_event.result_ptr = final_result;
-        }
-      } else {
-        DEBUG_DEBUG("No module handler for type: "
-                    << active_event.computation_type);
-      }
+  std::vector<std::pair<std::string, bool>> outcomes;
+  for (auto &[event_node, responses_node] : claimed) {
+    const ActiveEvent &active_event = event_node.mapped();
+    const auto &responses = responses_node.mapped();
 
-      completed_events.push_back(event_id);
+    finalizeEvent(active_event, responses, false);
+    auto contributors = collectPartials(active_event.event, responses).contributors;
+    for (const auto &participant : active_event.event.participants) {
+      outcomes.emplace_back(participant.client_id,
+                            contributors.count(participant.client_id) > 0);
     }
   }
 
-  if (!completed_events.empty()) {
-    events_lock.unlock();
-    responses_lock.unlock();
-    
-    std::unique_lock<std::shared_mutex> write_events_lock(active_events_mutex_);
-    std::unique_lock<std::shared_mutex> write_responses_lock(unprocessed_responses_mutex_);
-    
-    for (const std::string &event_id : completed_events) {
-      active_events_.erase(event_id);
-      unprocessed_responses_.erase(event_id);
+  recordParticipation(outcomes);
+}
+
+std::vector<std::pair<TribuneServer::ActiveEventNode, TribuneServer::ResponsesNode>>
+TribuneServer::claimEvents(const std::vector<std::string> &event_ids) {
+  std::vector<std::pair<ActiveEventNode, ResponsesNode>> claimed;
+
+  std::unique_lock<std::shared_mutex> events_lock(active_events_mutex_);
+  std::unique_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
+
+  for (const std::string &event_id : event_ids) {
+    auto event_node = active_events_.extract(event_id);
+    if (event_node.empty()) {
+      continue; // Another thread got there first
+    }
+
+    // Every claimed event gets a (possibly empty) response map
+    unprocessed_responses_.try_emplace(event_id);
+    auto responses_node = unprocessed_responses_.extract(event_id);
+    claimed.emplace_back(std::move(event_node), std::move(responses_node));
+    logState({{"op", "event_close"}, {"event_id", event_id}});
+  }
+  events_lock.unlock();
+  responses_lock.unlock();
+
+  if (!claimed.empty()) {
+    // A slot opened up for the next scheduled event
+    {
+      std::lock_guard<std::mutex> lock(event_mutex_);
+    }
+    scheduler_cv_.notify_all();
+  }
+  return claimed;
+}
+
+void TribuneServer::recordParticipation(
+    const std::vector<std::pair<std::string, bool>> &outcomes) {
+  if (outcomes.empty()) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> lock(roster_mutex_);
+  for (const auto &[client_id, responded] : outcomes) {
+    auto client_it = roster_.find(client_id);
+    if (client_it != roster_.end()) {
+      client_it->second.recordParticipation(responded);
     }
   }
 }
 
-void TribuneServer::periodicEventChecker() {
-  DEBUG_INFO("Started periodic event checker thread");
+void TribuneServer::eventDeadlineChecker() {
+  DEBUG_INFO("Started event deadline checker thread");
 
   while (!should_stop_) {
-    // Sleep for 5 seconds between checks
-    std::this_thread::sleep_for(std::chrono::seconds(5));
+    // Sleeps until the earliest event deadline passes or stop() is called
+    std::vector<std::string> due = event_deadlines_.waitExpired();
 
     if (should_stop_)
       break;
 
-    // Check for timeout events (events older than X seconds)
+    // Aggregate anything whose last response raced with its deadline
+    checkForCompleteResults();
+
     auto now = std::chrono::steady_clock::now();
+    auto timeout = std::chrono::seconds(config_.event_timeout_boundary);
     std::vector<std::string> timed_out_events;
 
     {
       std::shared_lock<std::shared_mutex> events_lock(active_events_mutex_);
-      std::shared_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
-
-      for (const auto &[event_id, active_event] : active_events_) {
-        auto age = std::chrono::duration_cast<std::chrono::seconds>(
-            now - active_event.created_time);
-
-        if (age.count() >
-            config_.event_timeout_boundary) { // X second timeout for complex
-                                              // peer-to-peer operations
-          auto responses_it = unprocessed_responses_.find(event_id);
-          int received_count =
-              responses_it != unprocessed_responses_.end()
-                  ? static_cast<int>(responses_it->second.size())
-                  : 0;
-
-          DEBUG_WARN("Event timed out after "
-                     << age.count() << " seconds with " << received_count << "/"
-                     << active_event.expected_participants << " responses");
-
+      for (const std::string &event_id : due) {
+        auto active_it = active_events_.find(event_id);
+        // Completed already, or the ID was reused by a newer event
+        if (active_it != active_events_.end() &&
+            active_it->second.created_time + timeout <= now) {
           timed_out_events.push_back(event_id);
         }
       }
+    }
 
-      if (!timed_out_events.empty()) {
-        events_lock.unlock();
-        responses_lock.unlock();
-        
-        std::unique_lock<std::shared_mutex> write_events_lock(active_events_mutex_);
-        std::unique_lock<std::shared_mutex> write_responses_lock(unprocessed_responses_mutex_);
-        
-        for (const std::string &event_id : timed_out_events) {
-          active_events_.erase(event_id);
-          unprocessed_responses_.erase(event_id);
-        }
+    std::vector<std::pair<std::string, bool>> outcomes;
+    for (auto &[event_node, responses_node] : claimEvents(timed_out_events)) {
+      const ActiveEvent &active_event = event_node.mapped();
+      const auto &responses = responses_node.mapped();
+      auto contributors = collectPartials(active_event.event, responses).contributors;
+      int received_count = static_cast<int>(contributors.size());
+
+      DEBUG_WARN("Event " << active_event.event_id << " timed out after "
+                 << config_.event_timeout_boundary << " seconds with "
+                 << received_count << "/"
+                 << active_event.expected_participants << " responses");
+
+      // Salvage the responsive participants' work if the module can
+      // reconstruct from them
+      if (config_.aggregate_partial_on_timeout && received_count > 0 &&
+          received_count >= active_event.threshold) {
+        DEBUG_WARN("Aggregating event " << active_event.event_id << " from "
+                   << received_count << " responses (threshold "
+                   << active_event.threshold << ")");
+        finalizeEvent(active_event, responses, true);
+      } else {
+        settle(active_event.completion, active_event.event_id,
+               EventStatus::TimedOut,
+               std::to_string(received_count) + "/" +
+                   std::to_string(active_event.expected_participants) +
+                   " participants contributed (threshold " +
+                   std::to_string(active_event.threshold) + ")");
       }
-    }
 
-    // Check for complete results
-    checkForCompleteResults();
+      for (const auto &participant : active_event.event.participants) {
+        outcomes.emplace_back(participant.client_id,
+                              contributors.count(participant.client_id) > 0);
+      }
+    }
+    recordParticipation(outcomes);
 
     // Print status if there are active events
     {
@@ -550,15 +1308,19 @@ void TribuneServer::periodicEventChecker() {
     }
   }
 
-  DEBUG_INFO("Periodic event checker thread stopped");
+  DEBUG_INFO("Event deadline checker thread stopped");
 }
 
 void TribuneServer::periodicPinger() {
   DEBUG_INFO("Started periodic ping thread");
   
   while (!should_stop_) {
-    std::this_thread::sleep_for(std::chrono::seconds(config_.ping_interval_seconds));
-    
+    {
+      std::unique_lock<std::mutex> lock(stop_mutex_);
+      stop_cv_.wait_for(lock, std::chrono::seconds(config_.ping_interval_seconds),
+                        [this] { return should_stop_.load(); });
+    }
+
     if (should_stop_) break;
     
     // Clean up expired connections
@@ -601,11 +1363,17 @@ void TribuneServer::periodicPinger() {
         for (const std::string &client_id : removable_clients) {
           DEBUG_INFO("Removing dead client: " << client_id);
           
+          auto client_it = roster_.find(client_id);
+          if (client_it == roster_.end()) {
+            continue;
+          }
+
           // Remove pooled connection for this client
-          connection_pool_.removeConnection(roster_[client_id].client_host_,
-                                            std::stoi(roster_[client_id].client_port_));
+          connection_pool_.removeConnection(client_it->second.client_host_,
+                                            std::stoi(client_it->second.client_port_));
           
           roster_.erase(client_id);
+          logState({{"op", "remove"}, {"client_id", client_id}});
         }
       }
     }
@@ -613,3 +1381,168 @@ void TribuneServer::periodicPinger() {
   
   DEBUG_INFO("Periodic ping thread stopped");
 }
+
+void TribuneServer::recoverState() {
+  auto start = std::chrono::steady_clock::now();
+  StateStore::Recovered recovered = state_store_->load();
+
+  // Runs from the constructor before any other thread exists, so the state
+  // maps are updated without their locks. Snapshots are stored as the
+  // records that rebuild them.
+  if (recovered.snapshot.is_object()) {
+    for (const auto &record : recovered.snapshot.at("records")) {
+      applyStateRecord(record);
+    }
+  }
+  for (const auto &record : recovered.records) {
+    applyStateRecord(record);
+  }
+  state_store_->open();
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  LOG("Recovered " << roster_.size() << " clients and " << active_events_.size()
+                   << " active events in " << elapsed.count() << "ms");
+}
+
+void TribuneServer::applyStateRecord(const nlohmann::json &record) {
+  const std::string op = record.at("op").get<std::string>();
+
+  if (op == "connect") {
+    ClientInfo info = record.at("client").get<ClientInfo>();
+    ClientState state(info.client_host, info.client_port, info.client_id,
+                      info.ed25519_pub);
+    // Recovered clients get a full timeout to ping in again
+    state.updatePingTime();
+    state.avg_response_ms_ = record.value("avg_response_ms", 0.0);
+    state.events_assigned_ = record.value("events_assigned", 0);
+    state.events_completed_ = record.value("events_completed", 0);
+    roster_.upsert(std::move(state));
+  } else if (op == "remove") {
+    roster_.erase(record.at("client_id").get<std::string>());
+  } else if (op == "event_open") {
+    Event event = record.at("event").get<Event>();
+
+    // Rebase the wall-clock creation time onto the steady clock, so the
+    // event keeps its original deadline
+    auto created_sys = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(record.at("created_ms").get<int64_t>()));
+    auto age = std::max(std::chrono::system_clock::duration::zero(),
+                        std::chrono::system_clock::now() - created_sys);
+    auto created_time = std::chrono::steady_clock::now() -
+                        std::chrono::duration_cast<std::chrono::steady_clock::duration>(age);
+
+    // openEvent() never logs an ID that is already active
+    std::string event_id = event.event_id;
+    active_events_.emplace(event_id,
+                           ActiveEvent{
+                               .event_id = event_id,
+                               .computation_type = event.computation_type,
+                               .expected_participants =
+                                   static_cast<int>(event.participants.size()),
+                               .threshold = record.at("threshold").get<int>(),
+                               .quorum = record.at("quorum").get<int>(),
+                               .created_time = created_time,
+                               .completion = nullptr, // The waiting caller is gone
+                               .module = modules_.find(event.computation_type),
+                               .event = std::move(event)});
+    event_deadlines_.schedule(
+        event_id, created_time + std::chrono::seconds(config_.event_timeout_boundary));
+  } else if (op == "response") {
+    EventResponse response = record.at("response").get<EventResponse>();
+    if (active_events_.count(response.event_id)) {
+      unprocessed_responses_[response.event_id][response.client_id] = response;
+    }
+  } else if (op == "event_close") {
+    std::string event_id = record.at("event_id").get<std::string>();
+    active_events_.erase(event_id);
+    unprocessed_responses_.erase(event_id);
+  } else {
+    DEBUG_WARN("Skipping unknown state record: " << op);
+  }
+}
+
+uint64_t TribuneServer::logState(nlohmann::json record) {
+  if (!state_store_) {
+    return 0;
+  }
+  return state_store_->append(std::move(record));
+}
+
+void TribuneServer::awaitState(uint64_t seq) {
+  if (state_store_ && seq > 0) {
+    state_store_->waitDurable(seq);
+  }
+}
+
+void TribuneServer::writeSnapshot() {
+  if (!state_store_) {
+    return;
+  }
+
+  nlohmann::json records = nlohmann::json::array();
+  uint64_t seq;
+  {
+    // Appends happen under these locks, so nothing is logged while we copy
+    std::shared_lock<std::shared_mutex> roster_lock(roster_mutex_);
+    std::shared_lock<std::shared_mutex> events_lock(active_events_mutex_);
+    std::shared_lock<std::shared_mutex> responses_lock(unprocessed_responses_mutex_);
+
+    for (const auto &[client_id, client_state] : roster_) {
+      records.push_back({{"op", "connect"},
+                         {"client", clientInfoOf(client_state)},
+                         {"avg_response_ms", client_state.avg_response_ms_},
+                         {"events_assigned", client_state.events_assigned_},
+                         {"events_completed", client_state.events_completed_}});
+    }
+
+    auto steady_now = std::chrono::steady_clock::now();
+    auto system_now = std::chrono::system_clock::now();
+    for (const auto &[event_id, active_event] : active_events_) {
+      auto created_sys =
+          system_now - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                           steady_now - active_event.created_time);
+      records.push_back(
+          {{"op", "event_open"},
+           {"event", active_event.event},
+           {"threshold", active_event.threshold},
+           {"quorum", active_event.quorum},
+           {"created_ms", std::chrono::duration_cast<std::chrono::milliseconds>(
+                              created_sys.time_since_epoch())
+                              .count()}});
+
+      auto responses_it = unprocessed_responses_.find(event_id);
+      if (responses_it != unprocessed_responses_.end()) {
+        for (const auto &[client_id, response] : responses_it->second) {
+          records.push_back({{"op", "response"}, {"response", response}});
+        }
+      }
+    }
+
+    seq = state_store_->lastSeq();
+  }
+
+  try {
+    state_store_->writeSnapshot({{"records", std::move(records)}}, seq);
+  } catch (const std::exception &e) {
+    DEBUG_ERROR("Failed to write snapshot: " << e.what());
+  }
+}
+
+void TribuneServer::periodicSnapshotter() {
+  DEBUG_INFO("Started snapshot thread");
+
+  while (!should_stop_) {
+    {
+      std::unique_lock<std::mutex> lock(stop_mutex_);
+      stop_cv_.wait_for(lock, std::chrono::seconds(config_.snapshot_interval_seconds),
+                        [this] { return should_stop_.load(); });
+    }
+
+    if (should_stop_) break;
+
+    writeSnapshot();
+  }
+
+  DEBUG_INFO("Snapshot thread stopped");
+}
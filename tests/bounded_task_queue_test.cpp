@@ -0,0 +1,107 @@
+// BoundedTaskQueue reports saturation once max_queued jobs wait, which is
+// when the server sheds requests with 503, refuses jobs at the hard limit,
+// and drains what it accepted on shutdown. Exits non-zero on any failed
+// check.
+
+#include "utils/bounded_task_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+// Holds the queue's only worker until released
+class Gate {
+public:
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    entered_ = true;
+    cv_.notify_all();
+    cv_.wait(lock, [this] { return open_; });
+  }
+  void awaitEntered() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return entered_; });
+  }
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    cv_.notify_all();
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool entered_ = false;
+  bool open_ = false;
+};
+
+void testSheddingAndHardLimit() {
+  constexpr size_t MAX_QUEUED = 4;
+  constexpr size_t HARD_LIMIT = 8;
+  BoundedTaskQueue queue(1, MAX_QUEUED, HARD_LIMIT);
+  Gate gate;
+  std::atomic<int> ran{0};
+
+  check(queue.enqueue([&] { gate.wait(); }), "blocking job accepted");
+  gate.awaitEntered(); // The worker is busy; everything else waits
+
+  for (size_t i = 0; i < MAX_QUEUED - 1; i++) {
+    check(queue.enqueue([&] { ran++; }), "job below max_queued accepted");
+  }
+  check(!queue.saturated(), "not saturated below max_queued");
+  check(queue.enqueue([&] { ran++; }), "job at max_queued accepted");
+  check(queue.saturated(), "saturated at max_queued, so handlers answer 503");
+  check(queue.queued() == MAX_QUEUED, "queued() counts waiting jobs");
+
+  for (size_t i = MAX_QUEUED; i < HARD_LIMIT; i++) {
+    check(queue.enqueue([&] { ran++; }), "job below the hard limit accepted");
+  }
+  check(!queue.enqueue([&] { ran++; }), "job at the hard limit refused");
+  check(queue.rejected() == 1, "refused job counted");
+
+  gate.open();
+  queue.shutdown(); // Drains, then joins
+  check(ran == static_cast<int>(HARD_LIMIT), "every accepted job ran before shutdown returned");
+  check(!queue.saturated() && queue.queued() == 0, "empty after draining");
+  check(!queue.enqueue([&] { ran++; }), "job after shutdown refused");
+  check(queue.rejected() == 2, "post-shutdown refusal counted");
+}
+
+void testUnbounded() {
+  BoundedTaskQueue queue(2, 0, 0);
+  Gate gate;
+  std::atomic<int> ran{0};
+  queue.enqueue([&] { gate.wait(); });
+  gate.awaitEntered();
+  for (int i = 0; i < 1000; i++) {
+    queue.enqueue([&] { ran++; });
+  }
+  check(!queue.saturated(), "max_queued 0 never sheds");
+  check(queue.rejected() == 0, "hard_limit 0 never refuses");
+  gate.open();
+  queue.shutdown();
+  check(ran == 1000, "every job ran");
+}
+
+} // namespace
+
+int main() {
+  testSheddingAndHardLimit();
+  testUnbounded();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,115 @@
+// ClientEvent's arrival bitmap reports completion to exactly one
+// storeShard() caller, even when participants resend concurrently, and
+// frozen shard views only cover the arrivals before the freeze. Exits
+// non-zero on any failed check.
+
+#include "client/client_event.hpp"
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+Event eventWith(size_t participants) {
+  Event event;
+  event.event_id = "event";
+  for (size_t i = 0; i < participants; i++) {
+    ClientInfo info;
+    info.client_id = "client-" + std::to_string(i);
+    event.participants.push_back(std::move(info));
+  }
+  return event;
+}
+
+void testSequentialArrivals() {
+  // More than 64 participants, so the bitmap spans several words
+  constexpr size_t N = 70;
+  ClientEvent client_event(eventWith(N), nullptr, ClientEvent::Clock::now());
+  check(client_event.participantIndex("client-65") == 65, "participant index lookup");
+  check(!client_event.participantIndex("stranger"), "unknown participant has no index");
+
+  int completions = 0;
+  for (size_t i = 0; i < N; i++) {
+    if (client_event.storeShard(i, "[" + std::to_string(i) + "]")) {
+      completions++;
+      check(i == N - 1, "only the last new arrival completes the event");
+    }
+    // A resend never counts twice
+    check(!client_event.storeShard(i, "[" + std::to_string(i) + "]"), "resend does not complete");
+  }
+  check(completions == 1, "exactly one completing arrival");
+  check(client_event.hasAllShards(), "all shards received");
+}
+
+void testFreeze() {
+  ClientEvent client_event(eventWith(4), nullptr, ClientEvent::Clock::now());
+  client_event.storeShard(2, "[2]");
+  client_event.storeShard(0, "[0]");
+  auto views = client_event.freezeShards();
+  check(views.size() == 2, "views cover the shards received so far");
+  check(views.size() == 2 && views[0].participant_index == 0 && views[0].data == "[0]" &&
+            views[1].participant_index == 2 && views[1].data == "[2]",
+        "views are in participant order");
+
+  client_event.storeShard(0, "[resend]");
+  client_event.storeShard(1, "[1]");
+  check(client_event.storeShard(3, "[3]"), "late arrivals still count towards completion");
+  check(views.size() == 2 && views[0].data == "[0]", "frozen views ignore later arrivals");
+
+  client_event.releaseShards();
+  check(client_event.freezeShards().empty(), "no views once released");
+}
+
+void testConcurrentCompletion() {
+  constexpr size_t N = 8;
+  constexpr int SENDS = 2;
+  constexpr int ROUNDS = 2000;
+  int wrong = 0;
+  for (int round = 0; round < ROUNDS; round++) {
+    ClientEvent client_event(eventWith(N), nullptr, ClientEvent::Clock::now());
+    std::atomic<int> completions{0};
+    std::atomic<int> computing{0};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < N; i++) {
+      threads.emplace_back([&, i]() {
+        for (int send = 0; send < SENDS; send++) {
+          if (client_event.storeShard(i, "[1]")) {
+            completions++;
+          }
+          if (client_event.hasAllShards() && client_event.tryStartComputing()) {
+            computing++;
+          }
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    if (completions != 1 || computing != 1) {
+      wrong++;
+    }
+  }
+  check(wrong == 0, "exactly one completion and one computation per event (" +
+                        std::to_string(wrong) + " rounds wrong)");
+}
+
+} // namespace
+
+int main() {
+  testSequentialArrivals();
+  testFreeze();
+  testConcurrentCompletion();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
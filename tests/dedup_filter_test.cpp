@@ -0,0 +1,116 @@
+// RotatingDedupFilter remembers a key for between ttl and ttl + one slice,
+// forgets it once its slice rotates out, and reports exactly one first
+// sighting under concurrent inserts. Times are explicit, so the checks do
+// not depend on the wall clock. Exits non-zero on any failed check.
+
+#include "utils/dedup_filter.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = RotatingDedupFilter::Clock;
+using std::chrono::milliseconds;
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+// Start of a slice for a 100 ms slice length
+const Clock::time_point T0 = Clock::time_point(milliseconds(1'000'000));
+
+void testRotation() {
+  // 4 generations of 100 ms
+  RotatingDedupFilter filter(milliseconds(400), 4, 1, 4);
+  check(filter.insertIfAbsent(7, T0), "first sighting");
+  check(!filter.insertIfAbsent(7, T0), "repeat in the same slice");
+  check(!filter.insertIfAbsent(7, T0 + milliseconds(399)), "repeat within the TTL");
+  check(!filter.insertIfAbsent(7, T0 + milliseconds(499)), "repeat within TTL + one slice");
+  check(filter.insertIfAbsent(7, T0 + milliseconds(500)), "forgotten once its slice expires");
+
+  // Keys from every live slice are remembered while newer slices fill up
+  RotatingDedupFilter rolling(milliseconds(400), 4, 1, 4);
+  for (uint64_t key = 100; key < 105; key++) {
+    check(rolling.insertIfAbsent(key, T0 + milliseconds(100 * (key - 100))),
+          "rolling key " + std::to_string(key) + " is new");
+  }
+  auto t = T0 + milliseconds(400);
+  for (uint64_t key = 100; key < 105; key++) {
+    check(!rolling.insertIfAbsent(key, t), "rolling key " + std::to_string(key) + " still live");
+  }
+  // Slice 0 is reused for epoch 5, which drops key 100 but not the others
+  t = T0 + milliseconds(500);
+  check(rolling.insertIfAbsent(999, t), "insert into the reused slice");
+  check(rolling.insertIfAbsent(100, t), "key from the reset slice is gone");
+  check(!rolling.insertIfAbsent(101, t), "key from a live slice survives the reset");
+}
+
+void testGrowthAndEmptyKey() {
+  RotatingDedupFilter filter(milliseconds(400), 4, 4, 4);
+  constexpr uint64_t KEYS = 10000;
+  for (uint64_t key = 1; key <= KEYS; key++) {
+    filter.insertIfAbsent(RotatingDedupFilter::hashPair("event", std::to_string(key)), T0);
+  }
+  int missing = 0;
+  for (uint64_t key = 1; key <= KEYS; key++) {
+    if (filter.insertIfAbsent(RotatingDedupFilter::hashPair("event", std::to_string(key)), T0)) {
+      missing++;
+    }
+  }
+  check(missing == 0, "every key survives table growth (" + std::to_string(missing) + " lost)");
+
+  // 0 marks empty slots internally but is still a usable key
+  check(filter.insertIfAbsent(0, T0), "key 0 is new");
+  check(!filter.insertIfAbsent(0, T0), "key 0 is remembered");
+
+  check(RotatingDedupFilter::hashPair("a", "b") != RotatingDedupFilter::hashPair("b", "a"),
+        "hashPair is order-sensitive");
+  check(RotatingDedupFilter::hashPair("ab", "c") != RotatingDedupFilter::hashPair("a", "bc"),
+        "hashPair separates its arguments");
+}
+
+void testConcurrentFirstSighting() {
+  RotatingDedupFilter filter(milliseconds(60000));
+  constexpr int THREADS = 8;
+  constexpr uint64_t KEYS = 2000;
+  std::vector<std::atomic<int>> firsts(KEYS);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&]() {
+      for (uint64_t key = 0; key < KEYS; key++) {
+        if (filter.insertIfAbsent(RotatingDedupFilter::hashPair("k", std::to_string(key)), T0)) {
+          firsts[key]++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  int wrong = 0;
+  for (const auto &count : firsts) {
+    if (count != 1) {
+      wrong++;
+    }
+  }
+  check(wrong == 0, "exactly one first sighting per key (" + std::to_string(wrong) + " wrong)");
+}
+
+} // namespace
+
+int main() {
+  testRotation();
+  testGrowthAndEmptyKey();
+  testConcurrentFirstSighting();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
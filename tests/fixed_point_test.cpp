@@ -0,0 +1,187 @@
+// FixedPointCodec rounds half to even and accepts exactly the values whose
+// rounded encoding fits in `bits` bits, up to MAX_BITS where the
+// magic-number trick stops being exact. Every value is checked both inside a
+// vector of four, which the AVX2 kernel encodes when the CPU has it, and in
+// the scalar tail. Exits non-zero on any failed check.
+
+#include "mpc/fixed_point.hpp"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+// Encoding of x, or nullopt if it does not fit; from std::nearbyint, which
+// rounds half to even in the default rounding mode
+std::optional<int64_t> reference(const FixedPointCodec &codec, double x) {
+  double scaled = std::nearbyint(std::ldexp(x, codec.fracBits()));
+  if (!(std::fabs(scaled) < std::ldexp(1.0, codec.bits() - 1))) {
+    return std::nullopt;
+  }
+  return static_cast<int64_t>(scaled);
+}
+
+// Encodes x at index 1 of `length` zeros; nullopt if encode() threw
+std::optional<int64_t> encodeAt(const FixedPointCodec &codec, double x, size_t length) {
+  std::vector<double> values(length, 0.0);
+  values[1] = x;
+  std::vector<uint64_t> out(length);
+  try {
+    codec.encode(values, out);
+  } catch (const std::overflow_error &) {
+    return std::nullopt;
+  }
+  return static_cast<int64_t>(out[1]);
+}
+
+void checkValue(const FixedPointCodec &codec, double x) {
+  auto expected = reference(codec, x);
+  std::string what = std::to_string(codec.bits()) + "-bit encoding of " +
+                     std::to_string(x) + " matches the reference";
+  check(encodeAt(codec, x, 8) == expected, what + " (vector)");
+  check(encodeAt(codec, x, 3) == expected, what + " (tail)");
+}
+
+void testRoundingBounds() {
+  for (int bits : {2, 16, 40, 51, FixedPointCodec::MAX_BITS}) {
+    for (int frac_bits : {0, bits / 2, bits - 1}) {
+      FixedPointCodec codec(frac_bits, bits);
+      double ulp = std::ldexp(1.0, -frac_bits);
+      double limit = std::ldexp(1.0, bits - 1);
+      // Largest and smallest encodings that fit, with ties either side
+      for (double k : {limit - 2, limit - 1.5, limit - 1, limit - 0.5, limit, limit + 1}) {
+        checkValue(codec, k * ulp);
+        checkValue(codec, -k * ulp);
+      }
+      // Ties round to even
+      for (double k : {0.5, 1.5, 2.5, -0.5, -1.5, -2.5}) {
+        checkValue(codec, k * ulp);
+      }
+      checkValue(codec, std::nextafter(0.5 * ulp, 1.0));
+      checkValue(codec, std::nextafter(-0.5 * ulp, -1.0));
+    }
+  }
+  check(reference(FixedPointCodec(0, 16), 2.5) == 2, "reference rounds half to even");
+
+  FixedPointCodec codec(16, 40);
+  for (double x : {std::numeric_limits<double>::quiet_NaN(),
+                   std::numeric_limits<double>::infinity(),
+                   -std::numeric_limits<double>::infinity()}) {
+    check(!encodeAt(codec, x, 8) && !encodeAt(codec, x, 3),
+          "non-finite " + std::to_string(x) + " rejected");
+  }
+}
+
+void testRoundTrip() {
+  FixedPointCodec codec(16, 40);
+  std::mt19937_64 rng(7);
+  std::normal_distribution<double> dist(0.0, 1000.0);
+  constexpr size_t N = 1003; // Not a multiple of four, so the tail runs too
+  std::vector<double> values(N);
+  for (auto &value : values) {
+    value = dist(rng);
+  }
+  std::vector<float> floats(values.begin(), values.end());
+
+  std::vector<uint64_t> encoded(N);
+  std::vector<uint64_t> encoded_floats(N);
+  codec.encode(values, encoded);
+  codec.encode(floats, encoded_floats);
+  std::vector<double> decoded(N);
+  codec.decode(encoded, decoded);
+
+  double half_ulp = std::ldexp(0.5, -codec.fracBits());
+  int mismatches = 0;
+  for (size_t i = 0; i < N; i++) {
+    if (static_cast<int64_t>(encoded[i]) != reference(codec, values[i]) ||
+        static_cast<int64_t>(encoded_floats[i]) != reference(codec, floats[i]) ||
+        std::fabs(decoded[i] - values[i]) > half_ulp) {
+      mismatches++;
+    }
+  }
+  check(mismatches == 0, "round trip within half an ulp (" + std::to_string(mismatches) +
+                             " mismatches)");
+
+  // Sums of encodings decode to the sum, including negative totals
+  std::vector<uint64_t> sums(N);
+  for (size_t i = 0; i < N; i++) {
+    sums[i] = encoded[i] + encoded[(i + 1) % N] + encoded[(i + 2) % N];
+  }
+  codec.decode(sums, decoded, 3);
+  int wrong_sums = 0;
+  for (size_t i = 0; i < N; i++) {
+    if (std::fabs(decoded[i] - (values[i] + values[(i + 1) % N] + values[(i + 2) % N])) >
+        3 * half_ulp) {
+      wrong_sums++;
+    }
+  }
+  check(wrong_sums == 0, "sums decode within three half ulps");
+
+  // The first value that does not fit is reported even mid-vector
+  values[901] = 1e9;
+  bool threw = false;
+  try {
+    codec.encode(values, encoded);
+  } catch (const std::overflow_error &e) {
+    threw = std::string(e.what()).find("index 901") != std::string::npos;
+  }
+  check(threw, "overflow reports the offending index");
+}
+
+void testLimits() {
+  FixedPointCodec codec(16, 40);
+  check(codec.maxSummands() == uint64_t{1} << 24, "maxSummands is 2^(64 - bits)");
+  std::vector<uint64_t> sum{0};
+  std::vector<double> out(1);
+  bool threw = false;
+  try {
+    codec.decode(sum, out, codec.maxSummands() + 1);
+  } catch (const std::overflow_error &) {
+    threw = true;
+  }
+  check(threw, "decoding more summands than fit throws");
+
+  for (auto [frac_bits, bits] : {std::pair{0, 1}, std::pair{0, FixedPointCodec::MAX_BITS + 1},
+                                 std::pair{-1, 16}, std::pair{16, 16}}) {
+    threw = false;
+    try {
+      FixedPointCodec invalid(frac_bits, bits);
+    } catch (const std::invalid_argument &) {
+      threw = true;
+    }
+    check(threw, "frac_bits " + std::to_string(frac_bits) + ", bits " + std::to_string(bits) +
+                     " rejected");
+  }
+
+  Event event;
+  check(!FixedPointCodec::fromEvent(event), "no codec without fixed_point metadata");
+  event.computation_metadata["fixed_point"] = {{"frac_bits", 8}, {"bits", 24}};
+  auto configured = FixedPointCodec::fromEvent(event);
+  check(configured && configured->fracBits() == 8 && configured->bits() == 24,
+        "codec configured from event metadata");
+}
+
+} // namespace
+
+int main() {
+  testRoundingBounds();
+  testRoundTrip();
+  testLimits();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+// HashRing ownership is stable: removing a shard only moves the keys it
+// owned, adding one only takes keys for itself, and the result does not
+// depend on the order shards joined. Exits non-zero on any failed check.
+
+#include "server/hash_ring.hpp"
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+constexpr int KEYS = 20000;
+
+std::string shard(int i) { return "10.0.0." + std::to_string(i) + ":8080"; }
+
+std::string key(int i) { return "event-" + std::to_string(i); }
+
+HashRing ringOf(const std::vector<int> &shards) {
+  HashRing ring;
+  for (int i : shards) {
+    ring.addNode(shard(i));
+  }
+  return ring;
+}
+
+std::vector<std::string> owners(const HashRing &ring) {
+  std::vector<std::string> result;
+  result.reserve(KEYS);
+  for (int i = 0; i < KEYS; i++) {
+    result.push_back(ring.ownerOf(key(i)));
+  }
+  return result;
+}
+
+void testRemoveNode() {
+  auto before = owners(ringOf({0, 1, 2, 3, 4}));
+  auto after = owners(ringOf({0, 1, 3, 4}));
+  int moved = 0;
+  int wrongly_moved = 0;
+  for (int i = 0; i < KEYS; i++) {
+    if (before[i] != after[i]) {
+      moved++;
+      if (before[i] != shard(2)) {
+        wrongly_moved++;
+      }
+    }
+    check(after[i] != shard(2), "no key owned by the removed shard");
+  }
+  check(wrongly_moved == 0,
+        "only the removed shard's keys move (" + std::to_string(wrongly_moved) + " others moved)");
+  // About a fifth of the keys belonged to shard 2
+  check(std::abs(moved - KEYS / 5) < KEYS / 20, "removal moves about 1/5 of the keys (" +
+                                                    std::to_string(moved) + ")");
+}
+
+void testAddNode() {
+  auto before = owners(ringOf({0, 1, 2, 3}));
+  auto after = owners(ringOf({0, 1, 2, 3, 4}));
+  int taken = 0;
+  int wrongly_moved = 0;
+  for (int i = 0; i < KEYS; i++) {
+    if (before[i] != after[i]) {
+      if (after[i] == shard(4)) {
+        taken++;
+      } else {
+        wrongly_moved++;
+      }
+    }
+  }
+  check(wrongly_moved == 0, "adding a shard only moves keys to it (" +
+                                std::to_string(wrongly_moved) + " moved elsewhere)");
+  check(std::abs(taken - KEYS / 5) < KEYS / 20, "the new shard takes about 1/5 of the keys (" +
+                                                    std::to_string(taken) + ")");
+}
+
+void testJoinOrderAndBalance() {
+  auto forward = owners(ringOf({0, 1, 2, 3, 4, 5, 6, 7}));
+  auto backward = owners(ringOf({7, 6, 5, 4, 3, 2, 1, 0}));
+  check(forward == backward, "ownership does not depend on join order");
+
+  std::unordered_map<std::string, int> load;
+  for (const auto &owner : forward) {
+    load[owner]++;
+  }
+  check(load.size() == 8, "every shard owns keys");
+  double expected = KEYS / 8.0;
+  for (const auto &[owner, count] : load) {
+    // 128 virtual nodes keep each shard well within 25% of its share
+    check(std::abs(count - expected) < expected * 0.25,
+          owner + " owns a fair share (" + std::to_string(count) + ")");
+  }
+}
+
+void testEdgeCases() {
+  HashRing ring;
+  check(ring.empty(), "new ring is empty");
+  bool threw = false;
+  try {
+    ring.ownerOf("anything");
+  } catch (const std::logic_error &) {
+    threw = true;
+  }
+  check(threw, "ownerOf on an empty ring throws");
+
+  ring.addNode(shard(0));
+  ring.addNode(shard(0));
+  check(ring.nodes().size() == 1, "adding a shard twice is a no-op");
+  check(ring.contains(shard(0)) && !ring.contains(shard(1)), "contains() matches addNode()");
+  check(ring.ownerOf("anything") == shard(0), "a single shard owns everything");
+
+  // Other processes and builds must agree on ownership, so the hash is pinned
+  check(HashRing::hash("") == 0xf52a15e9a9b5e89bULL, "hash of the empty string is stable");
+  check(HashRing::hash("localhost:8080") == 0x002a400f5bea18b7ULL, "hash of an address is stable");
+}
+
+} // namespace
+
+int main() {
+  testRemoveNode();
+  testAddNode();
+  testJoinOrderAndBalance();
+  testEdgeCases();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
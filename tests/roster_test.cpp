@@ -0,0 +1,124 @@
+// Roster keeps its slot array dense across upserts and swap-removes, and
+// sampleSlots() draws k distinct slots uniformly. Exits non-zero on any
+// failed check.
+
+#include "server/roster.hpp"
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+int failures = 0;
+
+void check(bool ok, const std::string &what) {
+  if (!ok) {
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+  }
+}
+
+ClientState client(int i) {
+  return ClientState("localhost", std::to_string(9000 + i), "client-" + std::to_string(i),
+                     "key-" + std::to_string(i));
+}
+
+// Every slot points at a live entry that knows its own slot
+void checkDense(const Roster &roster, const std::string &when) {
+  size_t entries = 0;
+  for (const auto &entry : roster) {
+    (void)entry;
+    entries++;
+  }
+  check(entries == roster.size(), when + ": slot count matches entries");
+  for (size_t slot = 0; slot < roster.size(); slot++) {
+    const ClientState &state = roster.at(slot);
+    check(state.roster_slot_ == slot, when + ": slot " + std::to_string(slot) + " is self-indexed");
+    auto it = roster.find(state.client_id_);
+    check(it != roster.end() && &it->second == &state,
+          when + ": slot " + std::to_string(slot) + " points into the map");
+  }
+}
+
+void testSwapRemove() {
+  Roster roster;
+  for (int i = 0; i < 10; i++) {
+    roster.upsert(client(i));
+  }
+  checkDense(roster, "after inserts");
+
+  // Reconnecting keeps the slot and replaces the state
+  size_t slot = roster.find("client-4")->second.roster_slot_;
+  ClientState reconnect = client(4);
+  reconnect.client_port_ = "1234";
+  roster.upsert(reconnect);
+  check(roster.size() == 10, "reconnect does not add a slot");
+  check(roster.find("client-4")->second.roster_slot_ == slot, "reconnect keeps its slot");
+  check(roster.at(slot).client_port_ == "1234", "reconnect replaces the state");
+
+  // Erasing from the middle moves the last slot into the hole
+  std::string last = roster.at(roster.size() - 1).client_id_;
+  size_t hole = roster.find("client-2")->second.roster_slot_;
+  check(roster.erase("client-2"), "erase an existing client");
+  check(roster.find("client-2") == roster.end(), "erased client is gone");
+  check(roster.size() == 9, "erase drops one slot");
+  check(roster.at(hole).client_id_ == last, "last slot moves into the hole");
+  checkDense(roster, "after middle erase");
+
+  check(roster.erase(roster.at(roster.size() - 1).client_id_), "erase the last slot");
+  checkDense(roster, "after tail erase");
+  check(!roster.erase("client-2"), "erasing twice fails");
+
+  while (roster.size() > 0) {
+    roster.erase(roster.at(0).client_id_);
+  }
+  checkDense(roster, "after emptying");
+}
+
+void testSampleSlots() {
+  Roster roster;
+  constexpr int N = 10;
+  for (int i = 0; i < N; i++) {
+    roster.upsert(client(i));
+  }
+  std::mt19937 rng(42);
+
+  check(roster.sampleSlots(0, rng).empty(), "k = 0 samples nothing");
+  auto all = roster.sampleSlots(N + 5, rng);
+  check(all.size() == N, "k > n is clamped to n");
+  check(std::unordered_set<size_t>(all.begin(), all.end()).size() == N,
+        "k = n samples every slot");
+
+  // Each slot is in a sample of 3 with probability 3/10
+  constexpr int TRIALS = 30000;
+  std::vector<int> hits(N);
+  for (int t = 0; t < TRIALS; t++) {
+    auto sample = roster.sampleSlots(3, rng);
+    std::unordered_set<size_t> distinct(sample.begin(), sample.end());
+    check(sample.size() == 3 && distinct.size() == 3, "sample of 3 is distinct");
+    for (size_t slot : sample) {
+      check(slot < N, "sampled slot in range");
+      if (slot < N) {
+        hits[slot]++;
+      }
+    }
+  }
+  double expected = TRIALS * 3.0 / N;
+  for (int i = 0; i < N; i++) {
+    // Roughly 10 standard deviations
+    check(std::abs(hits[i] - expected) < expected * 0.05,
+          "slot " + std::to_string(i) + " sampled uniformly (" + std::to_string(hits[i]) + ")");
+  }
+}
+
+} // namespace
+
+int main() {
+  testSwapRemove();
+  testSampleSlots();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// End-to-end round trip of ShamirSum through the real client routing: one
+// TribuneServer and five TribuneClients on loopback. Each client shares its
+// input, every participant sums the shares routed to it, and the server
+// interpolates the partials. Exits non-zero unless every event reconstructs
+// the exact sum.
+
+#include "client/tribune_client.hpp"
+#include "crypto/signature.hpp"
+#include "mpc/shamir.hpp"
+#include "server/tribune_server.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int PARTICIPANTS = 5;
+constexpr int THRESHOLD = 3;
+constexpr int EVENTS = 3;
+constexpr int SERVER_PORT = 18380;
+constexpr int CLIENT_BASE_PORT = 18400;
+
+// Contributes [value, 2 * value]
+class FixedDataModule : public DataCollectionModule {
+public:
+  explicit FixedDataModule(uint64_t value) : value_(value) {}
+  std::string collectData(const Event &event) override {
+    return nlohmann::json(std::vector<uint64_t>{value_, 2 * value_}).dump();
+  }
+
+private:
+  uint64_t value_;
+};
+
+bool waitForEndpoint(const std::string &host, int port, const std::string &path,
+                     bool post) {
+  httplib::Client cli(host, port);
+  cli.set_connection_timeout(0, 200000);
+  for (int attempt = 0; attempt < 50; attempt++) {
+    auto res = post ? cli.Post(path, "{}", "application/json") : cli.Get(path);
+    if (res && res->status == 200) {
+      return true;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  return false;
+}
+
+} // namespace
+
+int main() {
+  const std::string host = "localhost";
+
+  ServerConfig server_config("");
+  server_config.min_participants = PARTICIPANTS;
+  server_config.max_participants = PARTICIPANTS;
+  server_config.event_timeout_boundary = 30;
+  server_config.ping_interval_seconds = 1;
+  server_config.client_timeout_seconds = 3600;
+
+  TribuneServer server(host, SERVER_PORT, server_config);
+  server.registerModule<ShamirSum<Fp61>>("shamir_sum", THRESHOLD);
+  std::thread server_thread([&server]() { server.start(); });
+
+  std::vector<std::unique_ptr<TribuneClient>> clients;
+  auto shutdown = [&]() {
+    for (auto &client : clients) {
+      client->stop();
+    }
+    server.stop();
+    server_thread.join();
+  };
+
+  if (!waitForEndpoint(host, SERVER_PORT, "/", false)) {
+    std::cerr << "Server did not come up" << std::endl;
+    shutdown();
+    return 1;
+  }
+
+  ClientConfig client_config("");
+  std::unordered_map<std::string, uint64_t> client_values;
+  for (int i = 0; i < PARTICIPANTS; i++) {
+    auto keypair = SignatureUtils::generateKeyPair();
+    int port = CLIENT_BASE_PORT + i;
+    auto client = std::make_unique<TribuneClient>(
+        host, SERVER_PORT, host, port, keypair.second, keypair.first, client_config);
+    client->registerModule<ShamirSum<Fp61>>("shamir_sum", THRESHOLD);
+    // Distinct primes, so any misrouted share shows in the sum
+    uint64_t value = std::vector<uint64_t>{5, 7, 11, 13, 17}[i];
+    client->setDataCollectionModule(std::make_unique<FixedDataModule>(value));
+    client_values[client->getClientId()] = value;
+
+    client->startListening();
+    bool ready = waitForEndpoint(host, port, "/ping", true) && client->connectToSeed();
+    clients.push_back(std::move(client));
+    if (!ready) {
+      std::cerr << "Client " << i << " failed to start" << std::endl;
+      shutdown();
+      return 1;
+    }
+  }
+
+  int failures = 0;
+  for (int n = 0; n < EVENTS; n++) {
+    auto event = server.createEvent(DataRequestEvent, "shamir-" + std::to_string(n),
+                                    "shamir_sum");
+    if (!event) {
+      std::cerr << "Event " << n << ": not enough clients" << std::endl;
+      failures++;
+      continue;
+    }
+    uint64_t expected = 0;
+    for (const auto &participant : event->participants) {
+      expected += client_values[participant.client_id];
+    }
+
+    try {
+      FinalResult result = server.announceEvent(*event).get();
+      auto sum = result.value.get<std::vector<uint64_t>>();
+      if (sum != std::vector<uint64_t>{expected, 2 * expected}) {
+        std::cerr << "Event " << n << ": expected [" << expected << ","
+                  << 2 * expected << "], got " << result.value.dump() << std::endl;
+        failures++;
+      }
+    } catch (const std::exception &e) {
+      std::cerr << "Event " << n << " failed: " << e.what() << std::endl;
+      failures++;
+    }
+  }
+
+  shutdown();
+  std::cout << (failures == 0 ? "PASS" : "FAIL") << std::endl;
+  return failures == 0 ? 0 : 1;
+}